@@ -9,6 +9,10 @@ paddock_find_package(Threads REQUIRED QUIET)
 
 # Linux dependencies
 paddock_find_package(alsa QUIET)
+paddock_find_package(jack QUIET)
 paddock_find_package(liblo QUIET)
 
+# Development tools
+paddock_find_package(benchmark QUIET)
+
 paddock_find_package_post()
\ No newline at end of file
@@ -19,7 +19,8 @@ public:
 
     void setDirty(bool dirty);
 
-    virtual std::string serialize() const = 0;
+    /// @return An empty string for a program without content
+    virtual Expected<std::string> serialize() const = 0;
     virtual std::error_code deserialize(const std::string& bytes) = 0;
 
 signals:
@@ -4,6 +4,7 @@
 
 #include "Program.hpp"
 
+#include "pads/ConnectionManager.hpp"
 #include "pads/korgPadKontrol/Program.hpp"
 #include "pads/pads.hpp"
 
@@ -13,7 +14,11 @@
 #include "midi/errors.hpp"
 #include "midi/pads/KorgPadKontrol.hpp"
 
+#include "io/DeviceStates.hpp"
+#include "io/Journal.hpp"
 #include "io/Session.hpp"
+#include "io/files.hpp"
+#include "io/korgPadKontrol/Scene.hpp"
 
 #include "core/Log.hpp"
 
@@ -23,8 +28,6 @@
 #include "core/NsmSession.hpp"
 #endif
 
-#include <QTimer>
-
 namespace paddock
 {
 #ifndef PADDOCK_USE_LIBLO
@@ -67,6 +70,12 @@ std::optional<core::NsmSession> tryStartNsmSession(
 }
 #endif
 
+namespace
+{
+// Number of journal records after which the session file is rewritten
+constexpr size_t journalCompactionThreshold = 100;
+} // namespace
+
 class Session::_Impl
 {
 public:
@@ -84,6 +93,9 @@ public:
 
     ~_Impl()
     {
+        if (_midiInit.valid())
+            _midiInit.wait();
+
         // We need to ensure the controller is destroyed before the engine.
         if (_padController)
             std::visit([](auto controller) { delete controller; },
@@ -98,27 +110,47 @@ public:
                          const std::string& /* sessionName */,
                          const std::string& clientId)
     {
-        if (auto ret = execInMainThread([&] {
-                auto ret = openSession(projectPath);
-                if (ret)
-                    _name = clientId;
-                return ret;
-            });
-            !ret)
-        {
+        auto ret = execInMainThread([&] {
+            // The client id is the name of the MIDI client opened next.
+            _name = clientId;
+            if (_connections)
+                _connections->setMidiClientName(_name);
+            return openSession(projectPath);
+        });
+        if (!ret)
             return ret.error();
-        }
-        return std::error_code{}; // success
+        return *ret;
     }
 
     std::error_code save()
     {
-        if (auto ret = execInMainThread([&] { return saveSession(_filePath); });
-            !ret)
+        // The journal and the file path are replaced by the main thread
+        // when a session is opened, so they're only used there. The document
+        // is written by the journal I/O thread while this (NSM) thread
+        // waits.
+        auto written = execInMainThread(
+            [this]() -> Expected<std::future<std::error_code>> {
+                auto document = _sessionDocument();
+                if (!document)
+                    return tl::make_unexpected(document.error());
+                _storeDeviceState();
+                _writeDeviceStates(_deviceStates, _filePath);
+                return _writeDocument(std::move(*document));
+            });
+        if (!written)
+            return written.error();
+        if (!*written)
+            return written->error();
+
+        const auto error = (*written)->get();
+        if (!error)
         {
-            return ret.error();
+            execInMainThreadAsync([this] {
+                if (_program)
+                    _program->setDirty(false);
+            });
         }
-        return std::error_code{}; // success
+        return error;
     }
 
     void sendDirty(bool dirty)
@@ -127,14 +159,33 @@ public:
             _nsmSession->setDirty(dirty);
     }
 
+    /// Creates the MIDI engine in a background thread, the UI is loaded
+    /// meanwhile. The controller is connected by the ConnectionManager.
+    void startMidi()
+    {
+        _midiInit = std::async(std::launch::async, [this] {
+            auto engine = midi::Engine::create();
+            execInMainThreadAsync([this] {
+                if (auto error = initMidi())
+                {
+                    core::log() << "MIDI initialization failed:"
+                                << error.message();
+                    QCoreApplication::exit(-1);
+                }
+            });
+            return engine;
+        });
+    }
+
+    /// Waits for the MIDI initialization to finish if needed.
     std::error_code initMidi()
     {
-        if (_midiEngine)
-            return std::error_code{};
+        if (!_midiInit.valid())
+            return _midiError;
 
-        auto engine = midi::Engine::create();
+        auto engine = _midiInit.get();
         if (!engine)
-            return engine.error();
+            return _midiError = engine.error();
 
         _midiEngine = std::move(*engine);
         _midiEngine->setEngineEventCallback(
@@ -143,31 +194,24 @@ public:
                     [this, event] { _processEngineEvent(event); });
             });
 
+        _connections = std::make_unique<ConnectionManager>(
+            nullptr, &*_midiEngine, name());
+        connect(_connections.get(), &ConnectionManager::opened,
+                [this](midi::Pad* controller) {
+                    _setController(std::move(*controller));
+                });
+        connect(_connections.get(), &ConnectionManager::failed,
+                [](std::error_code error) {
+                    if (error != midi::EngineError::noDeviceFound &&
+                        error != midi::EngineError::clientIsNotADevice)
+                    {
+                        core::log() << error.message();
+                    }
+                });
+
+        // Otherwise the session manager will tell which session to open.
         if (!hasNsmSession())
-            return lookUpForKnownController();
-        return std::error_code{};
-    }
-
-    std::error_code lookUpForKnownController()
-    {
-        auto controller = makePad(_parent, &*_midiEngine, name());
-
-        if (controller)
-        {
-            _padController = std::make_optional(std::move(*controller));
-        }
-        else
-        {
-            if (controller.error() != midi::EngineError::noDeviceFound)
-            {
-                return controller.error();
-            }
-            _padController = std::nullopt;
-        }
-
-        emit _parent->controllerChanged();
-
-        _updateProgram();
+            _connections->connectAny();
 
         return std::error_code{};
     }
@@ -183,55 +227,75 @@ public:
 
     std::error_code openSession(std::string filePath)
     {
-        initMidi();
+        if (auto error = initMidi())
+            return error;
 
         _filePath = std::move(filePath);
 
-        core::log() << "Opening session " << filePath;
+        core::log() << "Opening session " << _filePath;
+
+        _readDeviceStates();
 
         auto session = io::readSession(_filePath);
 
         if (!session)
         {
             core::log() << session.error().message();
-            return lookUpForKnownController();
+            _replaceController(std::nullopt);
+            _updateProgram();
+            _connections->connectAny();
+            _openJournal();
+            return std::error_code{};
         }
 
-        _padController = makePad(_parent, session->model);
+        _replaceController(makePad(
+            _parent, static_cast<ControllerModel::Model>(session->model)));
         assert(_padController);
 
-        tryReconnectPad(*_padController, &*_midiEngine, name());
-
-        emit _parent->controllerChanged();
-
         if (auto ret = std::visit(
                 [&session](const auto& controller) {
                     return controller->program()->deserialize(session->program);
                 },
                 *_padController);
-            !ret)
+            ret)
         {
             core::log() << ret.message();
-            return lookUpForKnownController();
+            _replaceController(std::nullopt);
+            _updateProgram();
+            _connections->connectAny();
+            _openJournal();
+            return std::error_code{};
         }
 
         _updateProgram();
+        _openJournal();
+
+        // The program is uploaded once the device is connected.
+        _connections->connectAny();
 
         return std::error_code{}; // success
     }
 
-    std::error_code saveSession(std::string filePath) const
+    std::error_code saveSession(std::string filePath)
     {
-        if (_padController)
-            return midi::EngineError::noDeviceFound;
+        auto document = _sessionDocument();
+        if (!document)
+            return document.error();
+
+        // Saved as another file, the next saves and the journal follow it.
+        // A journal left there by another session is discarded by the
+        // compaction.
+        if (filePath != _filePath)
+        {
+            _filePath = std::move(filePath);
+            _openJournal(false);
+        }
+        if (auto error = _writeDocument(std::move(*document)).get())
+            return error;
 
-        return std::visit(
-            [&filePath](const auto& controller) {
-                return io::writeSession(
-                    filePath,
-                    {controller->model, controller->program()->serialize()});
-            },
-            *_padController);
+        _storeDeviceState();
+        _writeDeviceStates(_deviceStates, _filePath);
+        return std::error_code{};
     }
 
     Program* program() const { return _program; }
@@ -241,12 +305,56 @@ private:
 
     std::optional<midi::Engine> _midiEngine;
     std::optional<Pad> _padController;
+    std::future<Expected<midi::Engine>> _midiInit;
+    std::error_code _midiError;
+    // Declared after the engine, which its workers use.
+    std::unique_ptr<ConnectionManager> _connections;
 
     Program* _program{nullptr};
     std::string _filePath;
+    std::optional<io::Journal> _journal;
+    bool _isReplayingJournal{false};
+    io::DeviceStates _deviceStates;
     std::optional<core::NsmSession> _nsmSession;
     std::string _name{"Paddock"};
 
+    bool _isConnected() const
+    {
+        return _padController &&
+               std::visit(
+                   [](auto&& controller) { return controller->isConnected(); },
+                   *_padController);
+    }
+
+    void _replaceController(std::optional<Pad> controller)
+    {
+        if (_padController)
+            std::visit([](auto controller) { delete controller; },
+                       *_padController);
+        _padController = std::move(controller);
+        emit _parent->controllerChanged();
+    }
+
+    void _setController(midi::Pad&& controller)
+    {
+        _restoreDeviceState(controller);
+
+        if (!_padController)
+        {
+            _replaceController(makePad(_parent, std::move(controller)));
+            _updateProgram();
+            return;
+        }
+
+        // Only one controller is driven, other devices are closed.
+        if (_isConnected())
+            return;
+
+        // A pad restored from a session or whose device was unplugged.
+        if (auto error = setController(*_padController, std::move(controller)))
+            core::log() << error.message();
+    }
+
     void _processEngineEvent(const midi::events::EngineEvent& event)
     {
         using namespace midi::events;
@@ -262,79 +370,185 @@ private:
 
     void _processClientStartEvent(const midi::events::ClientStart& event)
     {
-        const auto retryOrLogError =
-            [this](const std::error_code error,
-                   const midi::events::ClientStart& event) {
-                if (error == midi::EngineError::deviceNotReady)
-                {
-                    // The HW dev files associated with the input ports may not
-                    // be ready by the time the system announces the MIDI clien.
-                    // In that case, we need to try connecting again a bit
-                    // later.
-
-                    QTimer::singleShot(200, [this, event]() {
-                        _processClientStartEvent(event);
-                    });
-                }
-                else if (error != midi::EngineError::clientIsNotADevice)
+        if (!_isConnected())
+            _connections->connectClient(event.client);
+    }
+
+    void _processClientExitEvent(const midi::events::ClientExit& event)
+    {
+        if (!_padController)
+            return;
+        std::visit(
+            [this, &event](auto&& controller) {
+                if (controller->deviceId() == event.client)
                 {
-                    core::log() << error.message();
+                    _storeDeviceState();
+                    controller->disconnect();
                 }
-            };
+            },
+            *_padController);
+    }
 
-        if (_padController)
+    void _readDeviceStates()
+    {
+        auto states =
+            io::DeviceStates::read(io::DeviceStates::filePath(_filePath));
+        if (!states)
         {
-            if (std::visit(
-                    [](auto&& controller) { return controller->isConnected(); },
-                    *_padController))
-            {
-                return;
-            }
-
-            if (auto error = tryReconnectPad(*_padController, &*_midiEngine,
-                                             name(), event.client))
-            {
-                retryOrLogError(error, event);
-                return;
-            }
+            core::log() << "Could not read device states:"
+                        << states.error().message();
+            _deviceStates = io::DeviceStates{};
             return;
         }
+        _deviceStates = std::move(*states);
+    }
 
-        auto controller = makePad(_parent, &*_midiEngine, name(), event.client);
-        if (controller)
-        {
-            _padController = std::move(*controller);
-            emit _parent->controllerChanged();
-        }
-        else
+    static void _writeDeviceStates(const io::DeviceStates& states,
+                                   const std::string& sessionFilePath)
+    {
+        // The cache is an optimization, the session is saved regardless.
+        if (auto error =
+                states.write(io::DeviceStates::filePath(sessionFilePath)))
         {
-            retryOrLogError(controller.error(), event);
+            core::log() << "Could not write device states:" << error.message();
         }
     }
 
-    void _processClientExitEvent(const midi::events::ClientExit& event)
+    /// Caches the scene of the connected device to skip querying it if it's
+    /// connected again.
+    void _storeDeviceState()
     {
-        if (!_padController)
+        if (!_isConnected())
             return;
         std::visit(
-            [&event](auto&& controller) {
-                if (controller->deviceId() == event.client)
-                    controller->disconnect();
+            [this](auto controller) {
+                const auto& scene = controller->deviceScene();
+                if (!scene)
+                    return;
+                if (auto bytes = io::korgPadKontrol::serializeScene(*scene))
+                {
+                    _deviceStates.setScene(controller->deviceIdentity(),
+                                           std::move(*bytes));
+                }
             },
             *_padController);
     }
 
+    void _restoreDeviceState(midi::Pad& controller)
+    {
+        std::visit(
+            [this](midi::KorgPadKontrol& controller) {
+                const auto* bytes = _deviceStates.scene(controller.identity());
+                if (!bytes)
+                    return;
+                if (auto scene = io::korgPadKontrol::deserializeScene(*bytes))
+                    controller.setKnownScene(*scene);
+            },
+            controller);
+    }
+
     void _updateProgram()
     {
-        _program =
-            std::visit([](auto controller) { return controller->program(); },
-                       *_padController);
+        _program = nullptr;
+        if (_padController)
+        {
+            _program = std::visit(
+                [](auto controller) { return controller->program(); },
+                *_padController);
+        }
 
-        connect(_program, &Program::dirtyChanged,
-                [this]() { this->sendDirty(_program->dirty()); });
+        if (_program)
+        {
+            connect(_program, &Program::dirtyChanged,
+                    [this]() { this->sendDirty(_program->dirty()); });
+            connect(_program, &Program::changed,
+                    [this]() { _journalProgram(); });
+        }
 
         emit _parent->programChanged();
     }
+
+    Expected<std::string> _sessionDocument() const
+    {
+        if (!_padController)
+            return tl::make_unexpected(midi::EngineError::noDeviceFound);
+
+        return std::visit(
+            [](const auto& controller) -> Expected<std::string> {
+                auto program = controller->program()->serialize();
+                if (!program)
+                    return tl::make_unexpected(program.error());
+                return io::toDocument(
+                    {static_cast<io::PadModel>(controller->model),
+                     std::move(*program)});
+            },
+            *_padController);
+    }
+
+    /// @param replay whether to restore the edits found in the journal
+    void _openJournal(bool replay = true)
+    {
+        _journal = std::nullopt;
+        auto journal = io::Journal::open(_filePath);
+        if (!journal)
+        {
+            core::log() << "Session journal not available:"
+                        << journal.error().message();
+            return;
+        }
+        _journal = std::move(*journal);
+
+        // Edits made after the last save, e.g. before a crash.
+        const auto& records = _journal->pendingRecords();
+        if (!replay || records.empty() || !_program)
+            return;
+        // The record is already in the journal, don't append it again.
+        _isReplayingJournal = true;
+        const auto error = _program->deserialize(records.back());
+        _isReplayingJournal = false;
+        if (error)
+        {
+            core::log() << "Could not replay session journal:"
+                        << error.message();
+            return;
+        }
+        _program->setDirty(true);
+    }
+
+    /// Replaces the session file, through the journal if there's one to
+    /// empty it too.
+    std::future<std::error_code> _writeDocument(std::string document)
+    {
+        if (_journal)
+            return _journal->compact(std::move(document));
+        // Deferred to write it in the thread that waits for the result.
+        auto write = [filePath = _filePath, document = std::move(document)] {
+            return io::writeFileAtomically(filePath, document);
+        };
+        return std::async(std::launch::deferred, std::move(write));
+    }
+
+    void _journalProgram()
+    {
+        if (!_journal || !_program || _isReplayingJournal)
+            return;
+
+        auto program = _program->serialize();
+        if (!program)
+        {
+            core::log() << "Could not journal the program:"
+                        << program.error().message();
+            return;
+        }
+        _journal->append(std::move(*program));
+
+        // Bound the size of the journal and the replay time.
+        if (_journal->recordCount() >= journalCompactionThreshold)
+        {
+            if (auto document = _sessionDocument())
+                _journal->compact(std::move(*document));
+        }
+    }
 };
 
 Session::Session()
@@ -344,9 +558,9 @@ Session::Session()
 
 Session::~Session() = default;
 
-std::error_code Session::init()
+void Session::init()
 {
-    return _impl->initMidi();
+    _impl->startMidi();
 }
 
 Program* Session::program() const
@@ -31,7 +31,9 @@ public:
     Session();
     ~Session();
 
-    std::error_code init();
+    /// Starts the MIDI initialization, which finishes asynchronously.
+    /// The controller property is notified when a controller is found.
+    void init();
 
     Program* program() const;
 
@@ -11,8 +11,6 @@
 #include <QQmlFileSelector>
 #include <QQuickView>
 
-#include <iostream>
-
 int main(int argc, char** argv)
 {
     QGuiApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
@@ -24,16 +22,13 @@ int main(int argc, char** argv)
     globals.argc = argc;
     globals.argv = argv;
 
-    paddock::initResources();
-    paddock::ui::initResources();
-
+    // MIDI discovery and the device handshake run in the background while
+    // the resources are initialized and the QML is loaded.
     paddock::Session session;
+    session.init();
 
-    if (auto error = session.init())
-    {
-        std::cerr << error.message() << std::endl;
-        return -1;
-    }
+    paddock::initResources();
+    paddock::ui::initResources();
 
     QQmlApplicationEngine engine;
     new QQmlFileSelector(&engine); // Engine takes owership
@@ -54,5 +49,5 @@ int main(int argc, char** argv)
 
     mainWindow->show();
 
-    app.exec();
+    return app.exec();
 }
@@ -0,0 +1,228 @@
+#include "ConnectionManager.hpp"
+
+#include "midi/Engine.hpp"
+#include "midi/errors.hpp"
+
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <list>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+// Retries are spaced 100, 200, 400... ms apart, ~6 s in total.
+constexpr auto initialRetryDelay = std::chrono::milliseconds{100};
+constexpr int maxRetries = 6;
+
+/// No client means any known controller.
+using Target = std::optional<midi::ClientId>;
+
+Expected<midi::ClientInfo> getDeviceInfo(midi::Engine* engine,
+                                         const midi::ClientId& deviceId)
+{
+    auto info = engine->queryClientInfo(deviceId);
+    if (!info)
+        return tl::make_unexpected(midi::EngineError::noDeviceFound);
+    if (info->type == midi::ClientType::user)
+        return tl::make_unexpected(midi::EngineError::clientIsNotADevice);
+
+    for (const auto& input : info->inputs)
+    {
+        if (input.hwDeviceId.empty())
+            return tl::make_unexpected(midi::EngineError::deviceNotReady);
+    }
+    for (const auto& output : info->outputs)
+    {
+        if (output.hwDeviceId.empty())
+            return tl::make_unexpected(midi::EngineError::deviceNotReady);
+    }
+
+    return std::move(*info);
+}
+
+Expected<midi::Pad> openController(midi::Engine* engine,
+                                   const std::string& midiClientName,
+                                   const Target& target)
+{
+    if (!target)
+        return engine->connect(midiClientName);
+
+    return getDeviceInfo(engine, *target)
+        .and_then([&](const midi::ClientInfo& deviceInfo) {
+            return engine->connect(midiClientName, deviceInfo);
+        });
+}
+} // namespace
+
+class ConnectionManager::_Impl
+{
+public:
+    _Impl(ConnectionManager* parent, midi::Engine* engine,
+          std::string midiClientName)
+        : _parent{parent}
+        , _engine{engine}
+        , _midiClientName{std::move(midiClientName)}
+    {
+    }
+
+    void setMidiClientName(std::string midiClientName)
+    {
+        _midiClientName = std::move(midiClientName);
+    }
+
+    bool isConnecting() const { return !_pending.empty(); }
+
+    void connect(Target target)
+    {
+        const bool wasConnecting = isConnecting();
+        _connect(std::move(target));
+        if (!wasConnecting && isConnecting())
+            emit _parent->isConnectingChanged();
+    }
+
+private:
+    ConnectionManager* _parent;
+    midi::Engine* _engine;
+    std::string _midiClientName;
+
+    std::vector<Target> _pending;
+    /// Waiting for the pending attempts to finish.
+    std::vector<Target> _deferred;
+    // Destroying a future returned by std::async waits for its thread.
+    std::list<std::future<void>> _workers;
+
+    void _connect(Target target)
+    {
+        // Attempts in progress or waiting to be retried already cover it.
+        if (_isPending(target) ||
+            std::find(_deferred.begin(), _deferred.end(), target) !=
+                _deferred.end())
+        {
+            return;
+        }
+
+        // The device connectAny opens may be one of the clients probed, they
+        // wait for each other to not open it and handshake with it twice. A
+        // client is not dropped, it may have started after connectAny looked
+        // for devices.
+        if (!_pending.empty() && (!target || _isPending(std::nullopt)))
+        {
+            _deferred.push_back(std::move(target));
+            return;
+        }
+
+        _pending.push_back(target);
+        _start(std::move(target), 0);
+    }
+
+    void _start(Target target, int attempt)
+    {
+        _collectWorkers();
+
+        _workers.push_back(std::async(
+            std::launch::async,
+            [this, target, attempt, engine = _engine,
+             name = _midiClientName] {
+                auto controller = std::make_shared<Expected<midi::Pad>>(
+                    openController(engine, name, target));
+                // Dropped if the manager is destroyed in the meantime.
+                QMetaObject::invokeMethod(
+                    _parent,
+                    [this, target, attempt, controller] {
+                        _finish(target, attempt, std::move(*controller));
+                    },
+                    Qt::QueuedConnection);
+            }));
+    }
+
+    void _finish(const Target& target, int attempt,
+                 Expected<midi::Pad> controller)
+    {
+        if (!controller && controller.error() ==
+                               midi::EngineError::deviceNotReady &&
+            attempt < maxRetries)
+        {
+            const auto delay = initialRetryDelay * (1 << attempt);
+            emit _parent->retryScheduled(attempt + 1,
+                                         static_cast<int>(delay.count()));
+            QTimer::singleShot(delay, _parent, [this, target, attempt] {
+                _start(target, attempt + 1);
+            });
+            return;
+        }
+
+        _pending.erase(std::find(_pending.begin(), _pending.end(), target));
+
+        if (controller)
+        {
+            // Only one controller is driven, the others aren't needed.
+            _deferred.clear();
+            emit _parent->opened(&*controller);
+        }
+        else
+        {
+            emit _parent->failed(controller.error());
+        }
+
+        if (_pending.empty())
+        {
+            for (auto& deferred : std::exchange(_deferred, {}))
+                _connect(std::move(deferred));
+        }
+
+        if (_pending.empty())
+            emit _parent->isConnectingChanged();
+    }
+
+    bool _isPending(const Target& target) const
+    {
+        return std::find(_pending.begin(), _pending.end(), target) !=
+               _pending.end();
+    }
+
+    void _collectWorkers()
+    {
+        _workers.remove_if([](const std::future<void>& worker) {
+            return worker.wait_for(std::chrono::seconds{0}) ==
+                   std::future_status::ready;
+        });
+    }
+};
+
+ConnectionManager::ConnectionManager(QObject* parent, midi::Engine* engine,
+                                     std::string midiClientName)
+    : QObject(parent)
+    , _impl{std::make_unique<_Impl>(this, engine, std::move(midiClientName))}
+{
+}
+
+ConnectionManager::~ConnectionManager() = default;
+
+void ConnectionManager::setMidiClientName(std::string midiClientName)
+{
+    _impl->setMidiClientName(std::move(midiClientName));
+}
+
+bool ConnectionManager::isConnecting() const
+{
+    return _impl->isConnecting();
+}
+
+void ConnectionManager::connectAny()
+{
+    _impl->connect(std::nullopt);
+}
+
+void ConnectionManager::connectClient(const midi::ClientId& client)
+{
+    _impl->connect(client);
+}
+
+} // namespace paddock
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "midi/pads/pads.hpp"
+#include "midi/types.hpp"
+
+#include <QObject>
+
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace paddock
+{
+namespace midi
+{
+class Engine;
+}
+
+/// Opens controllers in worker threads, so the discovery, the device opening
+/// and the handshake never block the main thread.
+///
+/// Concurrent requests to connect to the same client are merged. A request
+/// to connect to any controller and the requests for single clients wait
+/// for each other, they could open the same device. A device that is not
+/// ready yet, e.g. because its device files are still being created after a
+/// hot plug, is retried with exponential backoff.
+class ConnectionManager : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool isConnecting READ isConnecting NOTIFY isConnectingChanged)
+
+public:
+    ConnectionManager(QObject* parent, midi::Engine* engine,
+                      std::string midiClientName);
+    /// Waits for the attempts in progress.
+    ~ConnectionManager();
+
+    void setMidiClientName(std::string midiClientName);
+
+    bool isConnecting() const;
+
+    /// Connects to the first known controller found in the system.
+    void connectAny();
+    /// Connects to the controller of a client, e.g. one that just started.
+    void connectClient(const midi::ClientId& client);
+
+signals:
+    void isConnectingChanged();
+
+    /// The controller is valid during the emission, receivers take ownership
+    /// by moving from it.
+    void opened(paddock::midi::Pad* controller);
+
+    /// Errors noDeviceFound and clientIsNotADevice are reported too, they
+    /// are expected when probing clients.
+    void failed(std::error_code error);
+
+    /// A device wasn't ready, attempt counts the retries so far.
+    void retryScheduled(int attempt, int delayMs);
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+};
+
+} // namespace paddock
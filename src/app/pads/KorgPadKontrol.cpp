@@ -9,9 +9,24 @@
 #include "midi/pads/korgPadKontrol/Scene.hpp"
 
 #include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <cmath>
 
 namespace paddock
 {
+namespace
+{
+// Edits are coalesced for this long before uploading the scene to the device,
+// so dragging a knob in the editor doesn't queue one upload per step.
+constexpr auto uploadDelay = std::chrono::milliseconds{100};
+// The tempo shown follows the clock a few times per second, it's cleared if
+// no tick comes for a while, e.g. when the clock source is disconnected.
+constexpr auto tempoPollPeriod = std::chrono::milliseconds{250};
+constexpr auto clockTimeout = std::chrono::seconds{1};
+} // namespace
+
 class KorgPadKontrol::_Impl
 {
 public:
@@ -19,7 +34,7 @@ public:
         : _parent{parent}
         , _program{nullptr}
     {
-        setProgram(new korgPadKontrol::Program{parent});
+        _init();
     }
 
     _Impl(KorgPadKontrol* parent, midi::KorgPadKontrol&& controller)
@@ -27,7 +42,7 @@ public:
         , _controller{std::move(controller)}
         , _program{nullptr}
     {
-        setProgram(new korgPadKontrol::Program{parent});
+        _init();
     }
 
     bool isConnected() const { return static_cast<bool>(_controller); }
@@ -46,11 +61,27 @@ public:
         return _controller->setMode(mode);
     }
 
-    void disconnect() { _controller = std::nullopt; }
+    double tempo() const { return _tempo; }
+
+    void disconnect()
+    {
+        _uploadTimer.stop();
+        _tempoTimer.stop();
+        _controller = std::nullopt;
+        _uploadedScene = std::nullopt;
+        _setTempo(0);
+    }
 
     std::error_code setController(midi::KorgPadKontrol&& controller)
     {
         _controller = std::move(controller);
+        _tempoTimer.start();
+        // Known if it was restored from the device state cache, which is
+        // looked up by the identity of the device. It's trusted to save the
+        // scene dump query, and the upload if the program has the same
+        // scene. uploadProgramToDevice forces the upload when the scene was
+        // edited in the device meanwhile.
+        _uploadedScene = _controller->knownScene();
         assert(_program);
 
         return _getOrSetScene();
@@ -63,17 +94,32 @@ public:
         return _controller->deviceId();
     }
 
+    std::vector<std::byte> deviceIdentity() const
+    {
+        if (!_controller)
+            return {};
+        return _controller->identity();
+    }
+
+    const std::optional<midi::korgPadKontrol::Scene>& deviceScene() const
+    {
+        return _uploadedScene;
+    }
+
     korgPadKontrol::Program* program() { return _program; }
 
     void setProgram(korgPadKontrol::Program* prog)
     {
         if (_program)
             _program->disconnect(_parent);
+        _uploadTimer.stop();
 
         _program = prog;
         if (_program)
         {
             _getOrSetScene();
+            QObject::connect(_program, &korgPadKontrol::Program::changed,
+                             _parent, [this] { _uploadTimer.start(); });
         }
     }
 
@@ -86,6 +132,7 @@ public:
         if (!scene)
             return scene.error();
 
+        _uploadedScene = *scene;
         _program->resetScene(*scene);
 
         return std::error_code{};
@@ -99,7 +146,10 @@ public:
         if (!_program->hasScene())
             return midi::ProgramError::invalidProgram;
 
-        return _controller->setProgram(_program->midiProgram());
+        // An explicit upload is forced in case the scene was edited in the
+        // device.
+        _uploadTimer.stop();
+        return _upload(true);
     }
 
 private:
@@ -108,6 +158,84 @@ private:
 
     korgPadKontrol::Program* _program;
 
+    QTimer _uploadTimer;
+    /// The last scene uploaded to or read from the device
+    std::optional<midi::korgPadKontrol::Scene> _uploadedScene;
+
+    QTimer _tempoTimer;
+    double _tempo{0};
+
+    void _init()
+    {
+        _uploadTimer.setSingleShot(true);
+        _uploadTimer.setInterval(uploadDelay);
+        QObject::connect(&_uploadTimer, &QTimer::timeout, _parent,
+                         [this] { _uploadIfDirty(); });
+
+        _tempoTimer.setInterval(tempoPollPeriod);
+        QObject::connect(&_tempoTimer, &QTimer::timeout, _parent,
+                         [this] { _updateTempo(); });
+        if (_controller)
+            _tempoTimer.start();
+
+        setProgram(new korgPadKontrol::Program{_parent});
+    }
+
+    void _updateTempo()
+    {
+        if (!_controller)
+            return;
+        // Only read from this thread.
+        const auto state = _controller->tempo();
+        const auto now = midi::TempoTracker::Clock::now();
+        _setTempo(now - state.time < clockTimeout ? state.beatsPerMinute : 0);
+    }
+
+    void _setTempo(double tempo)
+    {
+        // Rounded so the jitter left by the tracker doesn't notify changes.
+        tempo = std::round(tempo * 10) / 10;
+        if (tempo == _tempo)
+            return;
+        _tempo = tempo;
+        emit _parent->tempoChanged();
+    }
+
+    void _uploadIfDirty()
+    {
+        if (!_controller || !_program || !_program->hasScene())
+            return;
+
+        // The program is set even if the scene is the same, the mapping may
+        // have changed. The scene is only uploaded if it differs.
+        const auto& scene = *_program->midiProgram().scene();
+        if (_uploadedScene)
+        {
+            const auto dirty = midi::korgPadKontrol::diffScenes(
+                *_uploadedScene, scene);
+            if (dirty.any())
+            {
+                core::log() << "Uploading scene, " << dirty.count()
+                            << " fields changed";
+            }
+        }
+
+        if (auto error = _upload(false))
+            core::log() << "Scene upload failed: " << error.message();
+    }
+
+    std::error_code _upload(bool force)
+    {
+        const auto& program = _program->midiProgram();
+        if (auto error = _controller->setProgram(program, force))
+        {
+            _uploadedScene = std::nullopt;
+            return error;
+        }
+        _uploadedScene = *program.scene();
+        return std::error_code{};
+    }
+
     Expected<midi::korgPadKontrol::Scene> _queryCurrentScene()
     {
         if (!_controller)
@@ -122,13 +250,18 @@ private:
 
         if (_program->hasScene())
         {
-            _controller->setProgram(_program->midiProgram());
+            return _upload(false);
         }
         else
         {
-            auto currentScene = _controller->queryCurrentScene();
+            // The cached scene saves a round trip to the device.
+            auto currentScene = _uploadedScene
+                                    ? Expected<midi::korgPadKontrol::Scene>{
+                                          *_uploadedScene}
+                                    : _controller->queryCurrentScene();
             if (!currentScene)
                 return currentScene.error();
+            _uploadedScene = *currentScene;
             _program->resetScene(std::move(*currentScene));
         }
         return std::error_code{};
@@ -160,6 +293,11 @@ bool KorgPadKontrol::isConnected() const
     return _impl->isConnected();
 }
 
+double KorgPadKontrol::tempo() const
+{
+    return _impl->tempo();
+}
+
 void KorgPadKontrol::disconnect()
 {
     _impl->disconnect();
@@ -180,6 +318,17 @@ midi::ClientId KorgPadKontrol::deviceId() const
     return _impl->deviceId();
 }
 
+std::vector<std::byte> KorgPadKontrol::deviceIdentity() const
+{
+    return _impl->deviceIdentity();
+}
+
+const std::optional<midi::korgPadKontrol::Scene>& KorgPadKontrol::deviceScene()
+    const
+{
+    return _impl->deviceScene();
+}
+
 korgPadKontrol::Program* KorgPadKontrol::program()
 {
     return _impl->program();
@@ -2,11 +2,15 @@
 
 #include "models.hpp"
 
+#include "midi/pads/korgPadKontrol/Scene.hpp"
 #include "midi/types.hpp"
 
 #include <QObject>
 
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace paddock
 {
@@ -26,6 +30,8 @@ class KorgPadKontrol : public QObject
 
     Q_PROPERTY(bool isNative READ isNative NOTIFY isNativeChanged)
     Q_PROPERTY(bool isConnected READ isConnected NOTIFY isConnectedChanged)
+    /// Beats per minute of the MIDI clock received, 0 without clock
+    Q_PROPERTY(double tempo READ tempo NOTIFY tempoChanged)
     Q_PROPERTY(paddock::ControllerModel::Model model MEMBER model CONSTANT)
     Q_PROPERTY(paddock::korgPadKontrol::Program* program READ program WRITE
                    setProgram NOTIFY programChanged)
@@ -41,6 +47,7 @@ public:
 
     bool isNative() const;
     bool isConnected() const;
+    double tempo() const;
 
     /// To be called from session when the device has been detected to be
     /// be disconnected
@@ -48,6 +55,10 @@ public:
 
     std::error_code setController(midi::KorgPadKontrol&& controller);
     midi::ClientId deviceId() const;
+    /// Empty if not connected
+    std::vector<std::byte> deviceIdentity() const;
+    /// The scene last uploaded to or read from the device
+    const std::optional<midi::korgPadKontrol::Scene>& deviceScene() const;
 
     korgPadKontrol::Program* program();
     void setProgram(korgPadKontrol::Program* prog);
@@ -61,6 +72,7 @@ public Q_SLOTS:
 signals:
     void isNativeChanged();
     void isConnectedChanged();
+    void tempoChanged();
     void programChanged();
 
 private:
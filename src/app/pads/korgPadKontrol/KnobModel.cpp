@@ -55,4 +55,46 @@ void KnobModel::updateModel()
     emit dataChanged(index(0, 0), index(1, 0));
 }
 
+void KnobModel::updateFields(const midi::korgPadKontrol::SceneDiff& diff)
+{
+    if (!hasScene())
+        return;
+    const auto& scene = *program()->midiProgram().scene();
+
+    using midi::korgPadKontrol::ScenePath;
+    using midi::korgPadKontrol::SceneField;
+    using midi::korgPadKontrol::SceneSection;
+
+    std::array<QVector<int>, knobCount> changedRoles;
+    forEachField(diff, [&](const ScenePath& path) {
+        if (path.section != SceneSection::knob)
+            return;
+
+        auto& roles = changedRoles[path.index];
+        switch (path.field)
+        {
+        case SceneField::knobType:
+            roles << static_cast<int>(Role::Enabled)
+                  << static_cast<int>(Role::ActionType);
+            break;
+        case SceneField::polarity:
+            roles.push_back(static_cast<int>(Role::ReversePolarity));
+            break;
+        case SceneField::parameter:
+            roles.push_back(static_cast<int>(Role::Parameter));
+            break;
+        default:
+            break;
+        }
+    });
+
+    for (int i = 0; i != knobCount; ++i)
+    {
+        if (changedRoles[i].empty())
+            continue;
+        _knobs[i] = scene.knobs[i];
+        emit dataChanged(index(i, 0), index(i, 0), changedRoles[i]);
+    }
+}
+
 } // namespace paddock::korgPadKontrol
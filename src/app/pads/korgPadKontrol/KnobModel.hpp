@@ -51,6 +51,7 @@ private:
     midi::korgPadKontrol::Scene::Knob _knobs[knobCount];
 
     void updateModel();
+    void updateFields(const midi::korgPadKontrol::SceneDiff& diff);
 };
 
 } // namespace paddock::korgPadKontrol
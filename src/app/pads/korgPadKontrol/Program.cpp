@@ -1,6 +1,6 @@
 #include "Program.hpp"
 
-#include "io/Serializer.hpp"
+#include "io/korgPadKontrol/Program.hpp"
 
 namespace paddock::korgPadKontrol
 {
@@ -21,19 +21,55 @@ bool Program::hasScene() const
 
 void Program::resetScene(midi::korgPadKontrol::Scene scene)
 {
+    midi::korgPadKontrol::SceneDiff diff;
+    if (const auto* current = _program.scene())
+        diff = midi::korgPadKontrol::diffScenes(*current, scene);
+    else
+        diff.set();
+
+    if (diff.none())
+        return;
+
     _program.setScene(std::move(scene));
+    emit sceneChanged(diff);
     emit changed();
     setDirty(true);
 }
 
-std::string Program::serialize() const
+void Program::setMapping(midi::Mapping mapping)
 {
-    return "{}";
+    if (mapping.rules() == _program.mapping().rules())
+        return;
+
+    _program.setMapping(std::move(mapping));
+    emit changed();
+    setDirty(true);
+}
+
+Expected<std::string> Program::serialize() const
+{
+    const auto* scene = _program.scene();
+    if (!scene)
+        return std::string{};
+
+    // The scene is validated when edited, so this is not expected to fail.
+    return io::korgPadKontrol::serializeProgram(_program);
 }
 
 std::error_code Program::deserialize(const std::string& bytes)
 {
-    (void)bytes;
+    // A program without scene, nothing to restore.
+    if (bytes.empty())
+        return std::error_code();
+
+    auto program = io::korgPadKontrol::deserializeProgram(bytes);
+    if (!program)
+        return program.error();
+
+    setMapping(program->mapping());
+    resetScene(*program->scene());
+    // The program has just been loaded, it's not modified.
+    setDirty(false);
     return std::error_code();
 }
 
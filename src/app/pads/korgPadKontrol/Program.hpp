@@ -16,12 +16,21 @@ public:
     const midi::korgPadKontrol::Program& midiProgram() const;
     bool hasScene() const;
 
-    // Reset the scene without triggering the programChanged signal
+    // Reset the scene without triggering the programChanged signal.
+    // Emits sceneChanged with the fields that differ, and nothing at all if
+    // the scene is unchanged.
     void resetScene(midi::korgPadKontrol::Scene scene);
 
-    std::string serialize() const;
+    /// Emits changed if the rules differ from the current ones.
+    void setMapping(midi::Mapping mapping);
+
+    Expected<std::string> serialize() const;
     std::error_code deserialize(const std::string& bytes);
 
+signals:
+    /// Emitted before changed() with the fields that have changed.
+    void sceneChanged(const paddock::midi::korgPadKontrol::SceneDiff& diff);
+
 private:
     midi::korgPadKontrol::Program _program;
 };
@@ -28,8 +28,8 @@ public:
             _program->disconnect(asQObject());
 
         _program = program;
-        QObject::connect(_program, &paddock::Program::changed, asQObject(),
-                         &Derived::updateModel);
+        QObject::connect(_program, &Program::sceneChanged, asQObject(),
+                         &Derived::updateFields);
 
         asQObject()->updateModel();
 
@@ -41,6 +41,20 @@ public:
         return _program && _program->hasScene();
     }
 
+protected:
+    /// Calls func(path) for each field set in diff.
+    template <typename Func>
+    static void forEachField(const midi::korgPadKontrol::SceneDiff& diff,
+                             Func&& func)
+    {
+        const auto& paths = midi::korgPadKontrol::sceneFieldPaths();
+        for (size_t i = 0; i != diff.size(); ++i)
+        {
+            if (diff[i])
+                func(paths[i]);
+        }
+    }
+
 private:
     Program* _program{nullptr};
 
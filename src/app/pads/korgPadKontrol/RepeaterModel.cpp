@@ -58,4 +58,48 @@ void RepeaterModel::updateModel()
     emit dataChanged(index(0, 0), index(1, 0));
 }
 
+void RepeaterModel::updateFields(const midi::korgPadKontrol::SceneDiff& diff)
+{
+    if (!hasScene())
+        return;
+    const auto& scene = *program()->midiProgram().scene();
+
+    using midi::korgPadKontrol::ScenePath;
+    using midi::korgPadKontrol::SceneField;
+    using midi::korgPadKontrol::SceneSection;
+
+    std::array<QVector<int>, repeaterCount> changedRoles;
+    forEachField(diff, [&](const ScenePath& path) {
+        if (path.section != SceneSection::repeater)
+            return;
+
+        auto& roles = changedRoles[path.index];
+        switch (path.field)
+        {
+        case SceneField::minSpeed:
+            roles.push_back(static_cast<int>(Role::MinSpeed));
+            break;
+        case SceneField::maxSpeed:
+            roles.push_back(static_cast<int>(Role::MaxSpeed));
+            break;
+        case SceneField::minVolume:
+            roles.push_back(static_cast<int>(Role::MinVolume));
+            break;
+        case SceneField::maxVolume:
+            roles.push_back(static_cast<int>(Role::MaxVolume));
+            break;
+        default:
+            break;
+        }
+    });
+
+    for (int i = 0; i != repeaterCount; ++i)
+    {
+        if (changedRoles[i].empty())
+            continue;
+        _repeaters[i] = i == 0 ? scene.flam : scene.roll;
+        emit dataChanged(index(i, 0), index(i, 0), changedRoles[i]);
+    }
+}
+
 } // namespace paddock::korgPadKontrol
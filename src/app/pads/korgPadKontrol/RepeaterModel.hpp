@@ -45,6 +45,7 @@ private:
     midi::korgPadKontrol::Scene::Repeater _repeaters[repeaterCount];
 
     void updateModel();
+    void updateFields(const midi::korgPadKontrol::SceneDiff& diff);
 };
 
 } // namespace paddock::korgPadKontrol
@@ -140,4 +140,85 @@ void TriggerModel::updateModel()
     }
 }
 
+void TriggerModel::updateFields(const midi::korgPadKontrol::SceneDiff& diff)
+{
+    if (!hasScene())
+        return;
+    const auto& scene = *program()->midiProgram().scene();
+
+    using midi::korgPadKontrol::ScenePath;
+    using midi::korgPadKontrol::SceneField;
+    using midi::korgPadKontrol::SceneSection;
+
+    std::array<QVector<int>, padCount> changedRoles;
+    const auto addRoles = [&](size_t pad, std::initializer_list<Role> roles) {
+        for (auto role : roles)
+            changedRoles[pad].push_back(static_cast<int>(role));
+    };
+
+    const std::array<short, 4> knobBits{
+        scene.knobs[0].padAssignmentBits, scene.knobs[1].padAssignmentBits,
+        scene.x.padAssignmentBits, scene.y.padAssignmentBits};
+
+    forEachField(diff, [&](const ScenePath& path) {
+        if (path.section == SceneSection::pad)
+        {
+            switch (path.field)
+            {
+            case SceneField::enabled:
+                addRoles(path.index, {Role::Enabled});
+                break;
+            case SceneField::midiChannel:
+                addRoles(path.index, {Role::MidiChannel});
+                break;
+            case SceneField::switchType:
+                addRoles(path.index, {Role::SwitchType});
+                break;
+            case SceneField::port:
+                addRoles(path.index, {Role::Port});
+                break;
+            case SceneField::flamRoll:
+                addRoles(path.index, {Role::HasFlamRoll});
+                break;
+            case SceneField::action:
+                addRoles(path.index,
+                         {Role::ActionType, Role::Note, Role::Velocity,
+                          Role::Parameter, Role::Value, Role::ReleaseValue});
+                break;
+            default:
+                break;
+            }
+            return;
+        }
+
+        if (path.field != SceneField::padAssignment ||
+            (path.section != SceneSection::knob &&
+             path.section != SceneSection::axis))
+        {
+            return;
+        }
+        // Knobs 1 and 2 first, then the x and y axes.
+        const auto knob =
+            path.index + (path.section == SceneSection::axis ? 2 : 0);
+        const auto role = static_cast<Role>(
+            static_cast<int>(Role::Knob1Assigned) + knob);
+        const auto changedBits = _knobAssignmentBits[knob] ^ knobBits[knob];
+        for (int i = 0; i != padCount; ++i)
+        {
+            if (changedBits & (1 << i))
+                addRoles(i, {role});
+        }
+    });
+
+    _knobAssignmentBits = knobBits;
+
+    for (int i = 0; i != padCount; ++i)
+    {
+        if (changedRoles[i].empty())
+            continue;
+        _pads[i] = scene.pads[i];
+        emit dataChanged(index(i, 0), index(i, 0), changedRoles[i]);
+    }
+}
+
 } // namespace paddock::korgPadKontrol
@@ -76,6 +76,7 @@ private:
     std::array<short, 4> _knobAssignmentBits;
 
     void updateModel();
+    void updateFields(const midi::korgPadKontrol::SceneDiff& diff);
 };
 
 } // namespace paddock::korgPadKontrol
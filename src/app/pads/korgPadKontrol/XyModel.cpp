@@ -61,4 +61,49 @@ void XyModel::updateModel()
     emit dataChanged(index(0, 0), index(1, 0));
 }
 
+void XyModel::updateFields(const midi::korgPadKontrol::SceneDiff& diff)
+{
+    if (!hasScene())
+        return;
+    const auto& scene = *program()->midiProgram().scene();
+
+    using midi::korgPadKontrol::ScenePath;
+    using midi::korgPadKontrol::SceneField;
+    using midi::korgPadKontrol::SceneSection;
+
+    std::array<QVector<int>, 2> changedRoles;
+    forEachField(diff, [&](const ScenePath& path) {
+        if (path.section != SceneSection::axis)
+            return;
+
+        auto& roles = changedRoles[path.index];
+        switch (path.field)
+        {
+        case SceneField::knobType:
+            roles << static_cast<int>(Role::Enabled)
+                  << static_cast<int>(Role::ActionType);
+            break;
+        case SceneField::polarity:
+            roles.push_back(static_cast<int>(Role::ReversePolarity));
+            break;
+        case SceneField::parameter:
+            roles.push_back(static_cast<int>(Role::Parameter));
+            break;
+        case SceneField::releaseValue:
+            roles.push_back(static_cast<int>(Role::ReleaseValue));
+            break;
+        default:
+            break;
+        }
+    });
+
+    for (int i = 0; i != 2; ++i)
+    {
+        if (changedRoles[i].empty())
+            continue;
+        _axes[i] = i == 0 ? scene.x : scene.y;
+        emit dataChanged(index(i, 0), index(i, 0), changedRoles[i]);
+    }
+}
+
 } // namespace paddock::korgPadKontrol
@@ -47,6 +47,7 @@ private:
     midi::korgPadKontrol::Scene::Axis _axes[2];
 
     void updateModel();
+    void updateFields(const midi::korgPadKontrol::SceneDiff& diff);
 };
 
 } // namespace paddock::korgPadKontrol
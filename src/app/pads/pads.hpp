@@ -3,33 +3,23 @@
 #include "KorgPadKontrol.hpp"
 #include "models.hpp"
 
-#include "midi/types.hpp"
-
-#include "utils/Expected.hpp"
+#include "midi/pads/pads.hpp"
 
 #include <optional>
+#include <system_error>
 #include <variant>
 
 namespace paddock
 {
-namespace midi
-{
-class Engine;
-}
-
 using Pad = std::variant<KorgPadKontrol*>;
 
-Expected<Pad> makePad(QObject* parent, midi::Engine* engine,
-                      std::string midiClientName);
-Expected<Pad> makePad(QObject* parent, midi::Engine* engine,
-                      std::string midiClientName,
-                      const midi::ClientId& deviceId);
 std::optional<Pad> makePad(QObject* parent, ControllerModel::Model model);
+/// Wraps a controller already connected, e.g. by the ConnectionManager.
+Pad makePad(QObject* parent, midi::Pad&& controller);
 
-std::error_code tryReconnectPad(Pad& pad, midi::Engine* engine,
-                                std::string midiClientName,
-                                const midi::ClientId& deviceId);
-std::error_code tryReconnectPad(Pad& pad, midi::Engine* engine,
-                                std::string midiClientName);
+/// Connects a pad restored from a session to a device.
+/// @return midi::EngineError::noDeviceFound if the controller is not of the
+/// pad model
+std::error_code setController(Pad& pad, midi::Pad&& controller);
 
 } // namespace paddock
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include "midi/platform/alsa/events.hpp"
+
+#include <alsa/asoundlib.h>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi;
+
+void makeEventFromAlsa(benchmark::State& state)
+{
+    snd_seq_event_t event{};
+    event.type = SND_SEQ_EVENT_NOTEON;
+    event.data.note.channel = 9;
+    event.data.note.note = 36;
+    event.data.note.velocity = 100;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(alsa::makeEvent(&event));
+}
+
+void makeEventToAlsa(benchmark::State& state)
+{
+    const events::Event event =
+        events::NoteOn{.channel = 9, .note = 36, .velocity = 100};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(alsa::makeEvent(event));
+}
+
+void makeControllerEventFromAlsa(benchmark::State& state)
+{
+    snd_seq_event_t event{};
+    event.type = SND_SEQ_EVENT_CONTROLLER;
+    event.data.control.channel = 0;
+    event.data.control.param = 1;
+    event.data.control.value = 64;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(alsa::makeEvent(&event));
+}
+
+void makeControllerEventToAlsa(benchmark::State& state)
+{
+    const events::Event event =
+        events::Controller{.channel = 0, .value = 64, .parameter = 1};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(alsa::makeEvent(event));
+}
+} // namespace
+
+BENCHMARK(makeEventFromAlsa);
+BENCHMARK(makeEventToAlsa);
+BENCHMARK(makeControllerEventFromAlsa);
+BENCHMARK(makeControllerEventToAlsa);
+
+} // namespace paddock
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include "utils/encodings.hpp"
+
+#include <random>
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+std::vector<std::byte> makeRandomBytes(size_t size)
+{
+    std::mt19937 generator{size};
+    std::uniform_int_distribution<int> distribution{0, 255};
+    std::vector<std::byte> bytes(size);
+    for (auto& byte : bytes)
+        byte = std::byte(distribution(generator));
+    return bytes;
+}
+
+void to7bitEncoding(benchmark::State& state)
+{
+    const auto input = makeRandomBytes(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(paddock::to7bitEncoding(input));
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+void from7bitEncoding(benchmark::State& state)
+{
+    auto input = makeRandomBytes(state.range(0));
+    for (auto& byte : input)
+        byte &= std::byte{0x7F};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(paddock::from7bitEncoding(input));
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+} // namespace
+
+// 138 bytes is the size of a scene dump, 7 and 8 a single encoding group.
+BENCHMARK(to7bitEncoding)->Arg(7)->Arg(138)->Arg(4096);
+BENCHMARK(from7bitEncoding)->Arg(8)->Arg(158)->Arg(4096);
+
+} // namespace paddock
@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include "midi/pads/korgPadKontrol/nativeEvents.hpp"
+#include "midi/pads/korgPadKontrol/sysex.hpp"
+
+namespace paddock
+{
+namespace
+{
+using namespace midi::korgPadKontrol;
+
+// Native mode messages as handed by the tokenizer (without F0 and F7).
+constexpr auto padHit = std::to_array(
+    {sysex::KORG, 0x40_b, sysex::SW_PROJECT, sysex::PADKONTROL,
+     sysex::PAD_OUTPUT, 0x45_b, 0x64_b});
+constexpr auto knobTurn = std::to_array(
+    {sysex::KORG, 0x40_b, sysex::SW_PROJECT, sysex::PADKONTROL,
+     sysex::KNOB_OUTPUT, 0x00_b, 0x40_b});
+constexpr auto xyMove = std::to_array(
+    {sysex::KORG, 0x40_b, sysex::SW_PROJECT, sysex::PADKONTROL,
+     sysex::XY_OUTPUT, 0x20_b, 0x60_b});
+
+template <const auto& message>
+void decodeEvent(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(midi::korgPadKontrol::decodeEvent(message));
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(decodeEvent, padHit);
+BENCHMARK_TEMPLATE(decodeEvent, knobTurn);
+BENCHMARK_TEMPLATE(decodeEvent, xyMove);
+
+} // namespace paddock
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include "core/Poller.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+
+namespace paddock
+{
+namespace
+{
+// Measures the time from a descriptor becoming readable until the Poller
+// thread runs its callback.
+void pollerWakeUpLatency(benchmark::State& state)
+{
+    int fds[2];
+    if (::pipe(fds) != 0)
+    {
+        state.SkipWithError("pipe() failed");
+        return;
+    }
+
+    auto handle = std::make_shared<pollfd>(pollfd{fds[0], POLLIN, 0});
+    std::atomic<int64_t> wokenAt{0};
+    const auto now = [] {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    };
+
+    core::Poller poller;
+    poller.add(handle, [&](const void*, int) {
+        char byte;
+        if (::read(fds[0], &byte, 1) == 1)
+            wokenAt.store(now(), std::memory_order_release);
+    });
+
+    const auto wakeUp = [&] {
+        wokenAt.store(0, std::memory_order_relaxed);
+        const auto start = now();
+        const char byte = 0;
+        if (::write(fds[1], &byte, 1) != 1)
+            return int64_t{-1};
+        int64_t end;
+        while ((end = wokenAt.load(std::memory_order_acquire)) == 0)
+            ;
+        return end - start;
+    };
+
+    // The first wake up also waits for the Poller to pick up the handle.
+    wakeUp();
+
+    for (auto _ : state)
+    {
+        const auto elapsed = wakeUp();
+        if (elapsed < 0)
+        {
+            state.SkipWithError("write() failed");
+            break;
+        }
+        state.SetIterationTime(std::chrono::duration<double>(
+                                   std::chrono::steady_clock::duration(elapsed))
+                                   .count());
+    }
+
+    poller.remove(handle).wait();
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+} // namespace
+
+BENCHMARK(pollerWakeUpLatency)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+} // namespace paddock
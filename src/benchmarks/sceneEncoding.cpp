@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include "midi/pads/korgPadKontrol/Scene.hpp"
+
+namespace paddock
+{
+namespace
+{
+using namespace midi::korgPadKontrol;
+
+Scene makeScene()
+{
+    Scene scene;
+    for (size_t i = 0; i != scene.pads.size(); ++i)
+    {
+        auto& pad = scene.pads[i];
+        pad.midiChannel = 10;
+        if (i % 2)
+            pad.action = Scene::Note{.note = midi::Value7bit(36 + i),
+                                     .velocity = midi::Value7bit(100)};
+        else
+            pad.action = Scene::Control{.param = midi::Value7bit(i),
+                                        .value = 127,
+                                        .releaseValue = 0};
+    }
+    scene.pedal.action = Scene::Note{
+        .note = 35, .velocity = Scene::Note::VelocityCurve::curve2};
+    scene.x.type = Scene::KnobType::PitchBend;
+    scene.x.releaseValue = 0;
+    scene.y.param = 1;
+    scene.y.releaseValue = 64;
+    scene.flam = {.minSpeed = 1, .maxSpeed = 50, .minVolume = 1,
+                  .maxVolume = 127};
+    scene.roll = {.minSpeed = 40, .maxSpeed = 240, .minVolume = 1,
+                  .maxVolume = 127};
+    scene.fixedVelocity = 100;
+    return scene;
+}
+
+void encodeScene(benchmark::State& state)
+{
+    const auto scene = makeScene();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(midi::korgPadKontrol::encodeScene(scene));
+}
+
+void decodeScene(benchmark::State& state)
+{
+    const auto payload = *midi::korgPadKontrol::encodeScene(makeScene());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(midi::korgPadKontrol::decodeScene(payload));
+}
+} // namespace
+
+BENCHMARK(encodeScene);
+BENCHMARK(decodeScene);
+
+} // namespace paddock
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include "midi/SysExStreamTokenizer.hpp"
+#include "midi/pads/korgPadKontrol/sysex.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi::korgPadKontrol;
+
+// Serves a recorded byte stream in chunks of at most the requested size,
+// like a raw MIDI device with input pending.
+class MemoryDevice
+{
+public:
+    explicit MemoryDevice(std::vector<std::byte> stream)
+        : _stream{std::move(stream)}
+    {
+    }
+
+    Expected<size_t> read(std::span<std::byte> buffer)
+    {
+        const auto size = std::min(buffer.size(), _stream.size() - _position);
+        std::memcpy(buffer.data(), _stream.data() + _position, size);
+        _position += size;
+        return size;
+    }
+
+    bool hasAvailableInput() const { return _position != _stream.size(); }
+
+    void rewind() { _position = 0; }
+
+    size_t size() const { return _stream.size(); }
+
+private:
+    std::vector<std::byte> _stream;
+    size_t _position{0};
+};
+
+// A native mode performance: pad hits with their releases, interleaved with
+// knob and x/y pad sweeps.
+std::vector<std::byte> makeNativeStream(size_t messageCount)
+{
+    std::vector<std::byte> stream;
+    const auto append = [&stream](std::byte type, std::byte a, std::byte b) {
+        const auto message =
+            std::to_array({sysex::START, sysex::KORG, 0x40_b,
+                           sysex::SW_PROJECT, sysex::PADKONTROL, type, a, b,
+                           sysex::END});
+        stream.insert(stream.end(), message.begin(), message.end());
+    };
+
+    for (size_t i = 0; i != messageCount; ++i)
+    {
+        const auto value = std::byte(i % 128);
+        switch (i % 4)
+        {
+        case 0:
+            append(sysex::PAD_OUTPUT, std::byte(0x40 | (i % 16)), value);
+            break;
+        case 1:
+            append(sysex::PAD_OUTPUT, std::byte(i % 16), 0x00_b);
+            break;
+        case 2:
+            append(sysex::KNOB_OUTPUT, 0x00_b, value);
+            break;
+        case 3:
+            append(sysex::XY_OUTPUT, value, 0x7F_b & ~value);
+            break;
+        }
+    }
+    return stream;
+}
+
+void processInput(benchmark::State& state)
+{
+    MemoryDevice device{makeNativeStream(state.range(0))};
+    midi::SysExStreamTokenizer<sysex::maxMessageSize, MemoryDevice> tokenizer;
+    tokenizer.reset(&device);
+
+    size_t messages = 0;
+    for (auto _ : state)
+    {
+        device.rewind();
+        tokenizer.processInput(
+            [&messages](std::span<const std::byte> payload) {
+                benchmark::DoNotOptimize(payload.data());
+                ++messages;
+            },
+            [] {});
+    }
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(state.iterations() * device.size());
+}
+} // namespace
+
+// A single message per poll wake up is the common case, bursts happen when
+// several controls are played at once.
+BENCHMARK(processInput)->Arg(1)->Arg(16)->Arg(1024);
+
+} // namespace paddock
@@ -1,12 +1,13 @@
 #include "Log.hpp"
 
-#include <QCoreApplication>
-#include <QDateTime>
-
+#include <chrono>
+#include <ctime>
 #include <fstream>
-
+#include <iomanip>
 #include <iostream>
 
+#include <unistd.h>
+
 namespace paddock::core
 {
 namespace
@@ -14,10 +15,18 @@ namespace
 #ifdef NDEBUG
 std::string _makeLogFileName()
 {
-    return "paddock." + std::to_string(QCoreApplication::applicationPid()) +
-           ".txt";
+    return "paddock." + std::to_string(::getpid()) + ".txt";
 }
 #endif
+
+std::tm _localTime()
+{
+    const auto now =
+        std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm time{};
+    ::localtime_r(&now, &time);
+    return time;
+}
 } // namespace
 
 struct Log
@@ -47,10 +56,9 @@ LogMessage& LogMessage::operator=(LogMessage&& other) = default;
 
 LogMessage::~LogMessage()
 {
-    _log->_out << QDateTime::currentDateTime()
-                      .toString("yyyy-MM-dd_hh-mm-ss ")
-                      .toStdString()
-               << _text.str() << std::endl;
+    const auto time = _localTime();
+    _log->_out << std::put_time(&time, "%Y-%m-%d_%H-%M-%S ") << _text.str()
+               << std::endl;
 }
 
 LogMessage log()
@@ -1,10 +1,15 @@
 #include "Poller.hpp"
 
 #include "platform/poll.hpp"
+#include "platform/thread.hpp"
+#include "platform/timer.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace paddock::core
@@ -12,13 +17,21 @@ namespace paddock::core
 namespace
 {
 constexpr std::chrono::milliseconds _pollTimeOut{100};
-}
+
+struct Timer
+{
+    Task callback;
+    bool periodic;
+    std::atomic_bool removed{false};
+};
+} // namespace
 
 class Poller::_Impl
 {
 public:
     _Impl()
         : _isRunning{true}
+        , _notifier{makeNotifier().value_or(PollHandle{})}
         , _thread{[this] { _runEventDispatcher(); }}
     {
     }
@@ -26,7 +39,7 @@ public:
     virtual ~_Impl()
     {
         _isRunning = false;
-        _condition.notify_one();
+        _wakeUp();
         _thread.join();
     }
 
@@ -34,13 +47,66 @@ public:
     {
         std::lock_guard<std::mutex> lock(_mutex);
         _descriptors.push_back(std::move(descriptor));
-        _condition.notify_one();
+        _descriptorsChanged = true;
+        _wakeUp();
+    }
+
+    Expected<PollHandle> addTimer(std::chrono::nanoseconds delay,
+                                  std::chrono::nanoseconds period,
+                                  Task callback)
+    {
+        auto handle = makeTimer();
+        if (!handle)
+            return handle;
+
+        auto timer = std::make_shared<Timer>(std::move(callback),
+                                             period.count() > 0);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _timers[handle->get()] = timer;
+        }
+        add(PollDescriptor{*handle, [this, timer, handle = *handle](
+                                        const void*, int) {
+                               _dispatchTimer(handle, *timer);
+                           }});
+
+        // A zero delay would disarm the timer.
+        if (auto error = setTimer(
+                *handle, std::max(delay, std::chrono::nanoseconds{1}),
+                period))
+        {
+            remove(*handle);
+            return tl::make_unexpected(error);
+        }
+        return handle;
+    }
+
+    void post(Task task)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+        _hasTasks = true;
+        _wakeUp();
+    }
+
+    ThreadOptionsError setThreadOptions(const ThreadOptions& options)
+    {
+        return core::setThreadOptions(_thread, options);
     }
 
     std::future<void> remove(const PollHandle& handle)
     {
         std::lock_guard<std::mutex> lock(_mutex);
 
+        if (auto timer = _timers.find(handle.get()); timer != _timers.end())
+        {
+            // The dispatcher may be going through a copy of the descriptors
+            // that still has the timer.
+            timer->second->removed = true;
+            setTimer(handle, {}, {});
+            _timers.erase(timer);
+        }
+
         auto iter = std::remove_if(
             _descriptors.begin(), _descriptors.end(),
             [&handle](const PollDescriptor& x) { return x.handle == handle; });
@@ -55,6 +121,8 @@ public:
         }
 
         _descriptors.erase(iter, _descriptors.end());
+        _descriptorsChanged = true;
+        _wakeUp();
 
         _removalPromises.emplace_back();
         return _removalPromises.back().get_future();
@@ -63,17 +131,36 @@ public:
 private:
     std::atomic_bool _isRunning{false};
     std::vector<PollDescriptor> _descriptors;
+    bool _descriptorsChanged{true};
     std::mutex _mutex;
     std::condition_variable _condition;
     std::vector<std::promise<void>> _removalPromises;
-    std::thread _thread;
+    std::unordered_map<const void*, std::shared_ptr<Timer>> _timers;
+    std::vector<Task> _tasks;
+    std::atomic_bool _hasTasks{false};
+    // Wakes up the dispatcher when the descriptors change or a task is
+    // posted. Without it the changes wait for the poll timeout.
+    PollHandle _notifier;
     bool _isThreadWaiting{false};
+    // Must be the last member, it uses all the others.
+    std::thread _thread;
+
+    void _wakeUp()
+    {
+        if (_notifier)
+            notify(_notifier);
+        else
+            _condition.notify_one();
+    }
 
     void _runEventDispatcher()
     {
+        // The dispatcher works on a copy, so the descriptors can be changed
+        // while it's polling. The copy is only refreshed when they change,
+        // the cost of a wake up doesn't grow with the number of devices.
+        std::vector<PollDescriptor> descriptors;
         while (_isRunning)
         {
-            std::vector<PollDescriptor> descriptors;
             {
                 std::unique_lock<std::mutex> lock(_mutex);
 
@@ -81,21 +168,57 @@ private:
                     promise.set_value();
                 _removalPromises.clear();
 
+                // The notifier is always polled, so there's never nothing
+                // to wait for when it exists.
                 _isThreadWaiting = true;
                 _condition.wait(lock, [this] {
-                    return !_descriptors.empty() || !_isRunning;
+                    return _notifier || !_descriptors.empty() || _hasTasks ||
+                           !_isRunning;
                 });
                 _isThreadWaiting = false;
-                // This copy wouldn't be efficient if a large number of
-                // descriptors needs to be handled, but this is not our case.
-                descriptors = _descriptors;
+                if (_descriptorsChanged)
+                {
+                    descriptors = _descriptors;
+                    if (_notifier)
+                    {
+                        descriptors.push_back(PollDescriptor{
+                            _notifier, [](const void* handle, int) {
+                                drain(handle);
+                            }});
+                    }
+                    _descriptorsChanged = false;
+                }
             };
 
             // The only error that doesn't throw is when the operation
             // was interrupted, which we can safely ignore.
             poll(descriptors, _pollTimeOut);
+
+            if (_hasTasks)
+                _runTasks();
         }
     }
+
+    void _dispatchTimer(const PollHandle& handle, Timer& timer)
+    {
+        if (drain(handle.get()) == 0 || timer.removed)
+            return;
+        if (!timer.periodic)
+            remove(handle);
+        timer.callback();
+    }
+
+    void _runTasks()
+    {
+        std::vector<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            tasks.swap(_tasks);
+            _hasTasks = false;
+        }
+        for (auto& task : tasks)
+            task();
+    }
 };
 
 Poller::Poller()
@@ -115,6 +238,23 @@ void Poller::add(PollHandle handle, PollCallback callback)
     _impl->add(PollDescriptor{std::move(handle), std::move(callback)});
 }
 
+Expected<PollHandle> Poller::addTimer(std::chrono::nanoseconds delay,
+                                      std::chrono::nanoseconds period,
+                                      Task callback)
+{
+    return _impl->addTimer(delay, period, std::move(callback));
+}
+
+void Poller::post(Task task)
+{
+    _impl->post(std::move(task));
+}
+
+ThreadOptionsError Poller::setThreadOptions(const ThreadOptions& options)
+{
+    return _impl->setThreadOptions(options);
+}
+
 std::future<void> Poller::remove(const PollHandle& handle)
 {
     return _impl->remove(handle);
@@ -1,8 +1,14 @@
 #pragma once
 
+#include "utils/Expected.hpp"
+
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
 
 namespace paddock::core
 {
@@ -14,6 +20,64 @@ using PollHandle = std::shared_ptr<void>;
 // TODO make events platform independent
 using PollCallback = std::function<void(const void* handle, int events)>;
 
+using Task = std::function<void()>;
+
+/// Scheduling of a poller thread.
+struct ThreadOptions
+{
+    enum class Policy
+    {
+        normal,
+        /// For the work that can wait, e.g. the system announcements.
+        background,
+        /// Preempts the threads with the other policies, it may require
+        /// privileges.
+        realTime
+    };
+
+    /// Shown by the system tools, truncated to 15 characters in Linux.
+    std::string name;
+    Policy policy{Policy::normal};
+    /// Only used with realTime, from 1 to 99 in Linux.
+    int priority{0};
+    /// The CPUs the thread can run on, any if empty.
+    std::vector<unsigned int> cpus;
+};
+
+/// The errors of the thread options that couldn't be applied. Each option is
+/// applied regardless of the others, e.g. the CPU affinity is kept when the
+/// real-time policy isn't allowed.
+struct ThreadOptionsError
+{
+    std::error_code name;
+    std::error_code scheduling;
+    std::error_code affinity;
+
+    explicit operator bool() const { return name || scheduling || affinity; }
+
+    /// The messages of the options that failed
+    std::string message() const
+    {
+        std::string result;
+        const auto append = [&result](const char* option,
+                                      const std::error_code& error) {
+            if (!error)
+                return;
+            if (!result.empty())
+                result += ", ";
+            result += option;
+            result += ": ";
+            result += error.message();
+        };
+        append("name", name);
+        append("scheduling", scheduling);
+        append("affinity", affinity);
+        return result;
+    }
+};
+
+/// Dispatches the events of the handles added, the timers and the tasks
+/// posted from a single thread.
 class Poller
 {
 public:
@@ -29,7 +93,24 @@ public:
 
     void add(PollHandle handle, PollCallback callback);
 
-    /// Remove a handle from the poller
+    /// Calls the callback from the dispatcher thread after delay, and then
+    /// every period unless it's zero. A periodic timer that overruns is
+    /// called once, not once per period missed.
+    /// @return the handle to stop the timer with remove
+    Expected<PollHandle> addTimer(std::chrono::nanoseconds delay,
+                                  std::chrono::nanoseconds period,
+                                  Task callback);
+
+    /// Runs the task from the dispatcher thread as soon as possible.
+    /// It can be called from any thread, including the dispatcher itself.
+    void post(Task task);
+
+    ThreadOptionsError setThreadOptions(const ThreadOptions& options);
+
+    /// Remove a handle or a timer from the poller
+    /// A timer isn't called after this returns, unless its callback is
+    /// already running in the dispatcher thread. One-shot timers are
+    /// removed when they expire.
     /// @return a future that will wait for the removal to actually take
     /// place
     std::future<void> remove(const PollHandle& handle);
@@ -0,0 +1,141 @@
+#include "PollerPool.hpp"
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace paddock::core
+{
+class PollerPool::_Impl
+{
+public:
+    _Impl() { _shards.push_back(std::make_unique<Poller>()); }
+
+    Shard addShard()
+    {
+        // Started outside the lock, the shards keep running meanwhile.
+        auto poller = std::make_unique<Poller>();
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (Shard shard = 0; shard != _shards.size(); ++shard)
+        {
+            if (!_shards[shard])
+            {
+                _shards[shard] = std::move(poller);
+                return shard;
+            }
+        }
+        _shards.push_back(std::move(poller));
+        return _shards.size() - 1;
+    }
+
+    void removeShard(Shard shard)
+    {
+        if (shard == defaultShard)
+            throw std::logic_error("The default shard can't be removed");
+
+        std::unique_ptr<Poller> poller;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            poller = std::move(_get(shard));
+        }
+        // Joined outside the lock, its callbacks may be using the pool.
+        poller.reset();
+    }
+
+    template <typename F>
+    auto withShard(Shard shard, F&& function)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return function(*_get(shard));
+    }
+
+    std::future<void> remove(const PollHandle& handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Only the shard that has the handle returns a future that may not
+        // be ready. The handles are few and seldom removed, it's not worth
+        // keeping track of their shards.
+        std::future<void> result;
+        for (auto& poller : _shards)
+        {
+            if (!poller)
+                continue;
+            auto future = poller->remove(handle);
+            if (!result.valid() || future.wait_for(std::chrono::seconds{0}) !=
+                                       std::future_status::ready)
+            {
+                result = std::move(future);
+            }
+        }
+        return result;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<Poller>> _shards;
+
+    std::unique_ptr<Poller>& _get(Shard shard)
+    {
+        if (shard >= _shards.size() || !_shards[shard])
+            throw std::out_of_range("Invalid shard");
+        return _shards[shard];
+    }
+};
+
+PollerPool::PollerPool()
+    : _impl{std::make_unique<_Impl>()}
+{
+}
+
+PollerPool::~PollerPool() = default;
+
+PollerPool::PollerPool(PollerPool&& other) = default;
+PollerPool& PollerPool::operator=(PollerPool&& other) = default;
+
+PollerPool::Shard PollerPool::addShard()
+{
+    return _impl->addShard();
+}
+
+void PollerPool::removeShard(Shard shard)
+{
+    _impl->removeShard(shard);
+}
+
+ThreadOptionsError PollerPool::setThreadOptions(Shard shard,
+                                                const ThreadOptions& options)
+{
+    return _impl->withShard(shard, [&options](Poller& poller) {
+        return poller.setThreadOptions(options);
+    });
+}
+
+void PollerPool::add(PollHandle handle, PollCallback callback, Shard shard)
+{
+    _impl->withShard(shard, [&](Poller& poller) {
+        poller.add(std::move(handle), std::move(callback));
+    });
+}
+
+Expected<PollHandle> PollerPool::addTimer(std::chrono::nanoseconds delay,
+                                          std::chrono::nanoseconds period,
+                                          Task callback, Shard shard)
+{
+    return _impl->withShard(shard, [&](Poller& poller) {
+        return poller.addTimer(delay, period, std::move(callback));
+    });
+}
+
+void PollerPool::post(Task task, Shard shard)
+{
+    _impl->withShard(shard, [&task](Poller& poller) {
+        poller.post(std::move(task));
+    });
+}
+
+std::future<void> PollerPool::remove(const PollHandle& handle)
+{
+    return _impl->remove(handle);
+}
+
+} // namespace paddock::core
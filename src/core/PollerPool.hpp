@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Poller.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <system_error>
+
+namespace paddock::core
+{
+/// A set of pollers, the shards, each one with a thread of its own.
+///
+/// Each handle is pinned to the shard it's added to, so a slow callback
+/// only delays the handles in the same shard. All the callbacks of a shard
+/// run in the same thread, the handles that share state must go to the same
+/// shard to keep it that way.
+class PollerPool
+{
+public:
+    using Shard = size_t;
+
+    /// Always running, it can't be removed.
+    static constexpr Shard defaultShard = 0;
+
+    PollerPool();
+
+    ~PollerPool();
+
+    PollerPool(PollerPool&& other);
+    PollerPool& operator=(PollerPool&& other);
+
+    PollerPool(const PollerPool& other) = delete;
+    PollerPool& operator=(const PollerPool& other) = delete;
+
+    /// Starts a new poller thread, the shards removed are reused.
+    Shard addShard();
+
+    /// Stops the thread of a shard, the handles still in it are dropped.
+    /// It mustn't be called from the shard itself.
+    void removeShard(Shard shard);
+
+    ThreadOptionsError setThreadOptions(Shard shard,
+                                        const ThreadOptions& options);
+
+    void add(PollHandle handle, PollCallback callback,
+             Shard shard = defaultShard);
+
+    Expected<PollHandle> addTimer(std::chrono::nanoseconds delay,
+                                  std::chrono::nanoseconds period,
+                                  Task callback, Shard shard = defaultShard);
+
+    void post(Task task, Shard shard = defaultShard);
+
+    /// Remove a handle or a timer from the shard that has it.
+    /// @return a future that will wait for the removal to actually take
+    /// place
+    std::future<void> remove(const PollHandle& handle);
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+};
+
+} // namespace paddock::core
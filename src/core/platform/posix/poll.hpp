@@ -5,15 +5,17 @@
 #include <cassert>
 #include <poll.h>
 #include <string.h>
+#include <vector>
 
 namespace paddock::core::posix
 {
 Expected<unsigned int> poll(std::span<PollDescriptor> descriptors,
                             std::chrono::milliseconds timeout)
 {
-    std::vector<struct pollfd> fds;
-    fds.reserve(descriptors.size());
-    for (auto descriptor : descriptors)
+    // Reused across calls to avoid an allocation per wake up.
+    thread_local std::vector<struct pollfd> fds;
+    fds.clear();
+    for (const auto& descriptor : descriptors)
     {
         assert(descriptor.handle);
         fds.push_back(*static_cast<pollfd*>(descriptor.handle.get()));
@@ -39,10 +41,11 @@ Expected<unsigned int> poll(std::span<PollDescriptor> descriptors,
         for (size_t i = 0; i != fds.size() && count != result; ++i)
         {
             auto& descriptor = descriptors[i];
-            if (fds[i].revents != 0 && descriptor.callback)
-            {
+            if (fds[i].revents == 0)
+                continue;
+            ++count;
+            if (descriptor.callback)
                 descriptor.callback(descriptor.handle.get(), fds[i].revents);
-            }
         }
         return result;
     }
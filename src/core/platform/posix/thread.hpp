@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../thread.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace paddock::core::posix
+{
+ThreadOptionsError setThreadOptions(std::thread& thread,
+                                    const ThreadOptions& options)
+{
+    const auto handle = thread.native_handle();
+    // pthread functions return the error instead of setting errno.
+    const auto makeError = [](int error) {
+        return std::make_error_code(static_cast<std::errc>(error));
+    };
+
+    ThreadOptionsError result;
+    if (!options.name.empty())
+    {
+        // The name is limited to 16 bytes including the terminator.
+        const auto name = options.name.substr(0, 15);
+        if (int error = ::pthread_setname_np(handle, name.c_str()))
+            result.name = makeError(error);
+    }
+
+    sched_param param{};
+    int policy = SCHED_OTHER;
+    switch (options.policy)
+    {
+    case ThreadOptions::Policy::normal:
+        break;
+    case ThreadOptions::Policy::background:
+        policy = SCHED_BATCH;
+        break;
+    case ThreadOptions::Policy::realTime:
+        policy = SCHED_FIFO;
+        param.sched_priority = options.priority;
+        break;
+    }
+    if (int error = ::pthread_setschedparam(handle, policy, &param))
+        result.scheduling = makeError(error);
+
+    if (!options.cpus.empty())
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (const auto cpu : options.cpus)
+        {
+            if (cpu >= CPU_SETSIZE)
+            {
+                result.affinity =
+                    std::make_error_code(std::errc::invalid_argument);
+                return result;
+            }
+            CPU_SET(cpu, &cpus);
+        }
+        if (int error = ::pthread_setaffinity_np(handle, sizeof(cpus), &cpus))
+            result.affinity = makeError(error);
+    }
+
+    return result;
+}
+
+} // namespace paddock::core::posix
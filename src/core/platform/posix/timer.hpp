@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../timer.hpp"
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace paddock::core::posix
+{
+namespace
+{
+std::error_code lastError()
+{
+    return std::make_error_code(static_cast<std::errc>(errno));
+}
+
+/// The descriptor is closed with the last copy of the handle.
+PollHandle makeHandle(int fd)
+{
+    return PollHandle{new pollfd{fd, POLLIN, 0}, [](pollfd* descriptor) {
+                          ::close(descriptor->fd);
+                          delete descriptor;
+                      }};
+}
+
+int getDescriptor(const void* handle)
+{
+    return static_cast<const pollfd*>(handle)->fd;
+}
+
+timespec makeTimeSpec(std::chrono::nanoseconds time)
+{
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(time);
+    return timespec{.tv_sec = time_t(seconds.count()),
+                    .tv_nsec = long((time - seconds).count())};
+}
+} // namespace
+
+Expected<PollHandle> makeTimer()
+{
+    const int fd =
+        ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1)
+        return tl::make_unexpected(lastError());
+    return makeHandle(fd);
+}
+
+std::error_code setTimer(const PollHandle& timer,
+                         std::chrono::nanoseconds delay,
+                         std::chrono::nanoseconds period)
+{
+    const itimerspec spec{.it_interval = makeTimeSpec(period),
+                          .it_value = makeTimeSpec(delay)};
+    if (::timerfd_settime(getDescriptor(timer.get()), 0, &spec, nullptr) ==
+        -1)
+    {
+        return lastError();
+    }
+    return std::error_code{};
+}
+
+Expected<PollHandle> makeNotifier()
+{
+    const int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd == -1)
+        return tl::make_unexpected(lastError());
+    return makeHandle(fd);
+}
+
+void notify(const PollHandle& notifier)
+{
+    const uint64_t one = 1;
+    // It can only fail if the counter is about to overflow, the notifier
+    // is readable anyway.
+    [[maybe_unused]] const auto result =
+        ::write(getDescriptor(notifier.get()), &one, sizeof(one));
+}
+
+uint64_t drain(const void* handle)
+{
+    uint64_t count = 0;
+    if (::read(getDescriptor(handle), &count, sizeof(count)) !=
+        sizeof(count))
+    {
+        return 0;
+    }
+    return count;
+}
+
+} // namespace paddock::core::posix
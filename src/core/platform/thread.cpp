@@ -0,0 +1,23 @@
+#include "thread.hpp"
+
+#include "../errors.hpp"
+
+#ifdef Linux
+#include "posix/thread.hpp"
+#endif
+
+namespace paddock::core
+{
+ThreadOptionsError setThreadOptions(std::thread& thread,
+                                    const ThreadOptions& options)
+{
+#ifdef Linux
+    return posix::setThreadOptions(thread, options);
+#else
+    (void)thread;
+    (void)options;
+    return ThreadOptionsError{.scheduling = Error::unimplemented};
+#endif
+}
+
+} // namespace paddock::core
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../Poller.hpp"
+
+#include <system_error>
+#include <thread>
+
+namespace paddock::core
+{
+/// Applies the name, scheduling policy and CPU affinity to a running thread.
+/// @return the errors of the options that couldn't be applied, the others
+/// are applied anyway
+ThreadOptionsError setThreadOptions(std::thread& thread,
+                                    const ThreadOptions& options);
+
+} // namespace paddock::core
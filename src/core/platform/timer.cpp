@@ -0,0 +1,56 @@
+#include "timer.hpp"
+
+#include "../errors.hpp"
+
+#ifdef Linux
+#include "posix/timer.hpp"
+#endif
+
+namespace paddock::core
+{
+Expected<PollHandle> makeTimer()
+{
+#ifdef Linux
+    return posix::makeTimer();
+#else
+    return tl::make_unexpected(Error::unimplemented);
+#endif
+}
+
+std::error_code setTimer(const PollHandle& timer,
+                         std::chrono::nanoseconds delay,
+                         std::chrono::nanoseconds period)
+{
+#ifdef Linux
+    return posix::setTimer(timer, delay, period);
+#else
+    return Error::unimplemented;
+#endif
+}
+
+Expected<PollHandle> makeNotifier()
+{
+#ifdef Linux
+    return posix::makeNotifier();
+#else
+    return tl::make_unexpected(Error::unimplemented);
+#endif
+}
+
+void notify(const PollHandle& notifier)
+{
+#ifdef Linux
+    posix::notify(notifier);
+#endif
+}
+
+uint64_t drain(const void* handle)
+{
+#ifdef Linux
+    return posix::drain(handle);
+#else
+    return 0;
+#endif
+}
+
+} // namespace paddock::core
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../Poller.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <system_error>
+
+namespace paddock::core
+{
+/// A handle that becomes readable when the timer expires, disarmed until
+/// setTimer is called.
+Expected<PollHandle> makeTimer();
+
+/// Arms the timer to expire after delay and then every period, a zero period
+/// means once. A zero delay disarms it.
+std::error_code setTimer(const PollHandle& timer,
+                         std::chrono::nanoseconds delay,
+                         std::chrono::nanoseconds period);
+
+/// A handle that becomes readable when notify is called from any thread.
+Expected<PollHandle> makeNotifier();
+
+void notify(const PollHandle& notifier);
+
+/// Makes a timer or notifier handle not readable again.
+/// @param handle the pointer stored in the handle, as passed to the
+///        PollCallback
+/// @return the expirations or notifications since the last call
+uint64_t drain(const void* handle);
+
+} // namespace paddock::core
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "core/Poller.hpp"
+
+#include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace paddock
+{
+using namespace std::chrono_literals;
+
+TEST(Poller, one_shot_timer)
+{
+    core::Poller poller;
+    std::promise<std::thread::id> called;
+    const auto start = std::chrono::steady_clock::now();
+    auto timer = poller.addTimer(20ms, 0ms, [&called] {
+        called.set_value(std::this_thread::get_id());
+    });
+    ASSERT_TRUE(timer);
+
+    auto future = called.get_future();
+    ASSERT_EQ(future.wait_for(1s), std::future_status::ready);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+    // Already removed when it expired
+    poller.remove(*timer).wait();
+}
+
+TEST(Poller, periodic_timer)
+{
+    core::Poller poller;
+    std::atomic<int> count{0};
+    std::promise<void> done;
+    auto timer = poller.addTimer(1ms, 5ms, [&count, &done] {
+        if (++count == 3)
+            done.set_value();
+    });
+    ASSERT_TRUE(timer);
+    ASSERT_EQ(done.get_future().wait_for(1s), std::future_status::ready);
+
+    poller.remove(*timer).wait();
+    const int stopped = count;
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(count, stopped);
+}
+
+TEST(Poller, remove_timer_from_dispatcher)
+{
+    core::Poller poller;
+    std::atomic<int> count{0};
+    std::array<core::PollHandle, 2> timers;
+    // Both likely expire in the same wake up, the first one called removes
+    // the other.
+    const auto addTimer = [&](size_t i) {
+        return poller.addTimer(50ms, 50ms, [&, i] {
+            ++count;
+            poller.remove(timers[i]);
+            poller.remove(timers[1 - i]);
+        });
+    };
+    auto first = addTimer(0);
+    auto second = addTimer(1);
+    ASSERT_TRUE(first && second);
+    // Assigned from the dispatcher to not race with the callbacks.
+    poller.post([&] { timers = {*first, *second}; });
+
+    std::this_thread::sleep_for(200ms);
+    EXPECT_EQ(count, 1);
+}
+
+TEST(Poller, post)
+{
+    core::Poller poller;
+    std::promise<std::thread::id> first;
+    std::promise<void> second;
+    poller.post([&] {
+        first.set_value(std::this_thread::get_id());
+        // Posted from the dispatcher itself
+        poller.post([&second] { second.set_value(); });
+    });
+
+    auto future = first.get_future();
+    ASSERT_EQ(future.wait_for(1s), std::future_status::ready);
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+    EXPECT_EQ(second.get_future().wait_for(1s), std::future_status::ready);
+}
+
+} // namespace paddock
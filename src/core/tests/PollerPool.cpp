@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "core/PollerPool.hpp"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <sched.h>
+
+namespace paddock
+{
+using namespace std::chrono_literals;
+
+namespace
+{
+std::thread::id shardThread(core::PollerPool& pool,
+                            core::PollerPool::Shard shard)
+{
+    std::promise<std::thread::id> id;
+    pool.post([&id] { id.set_value(std::this_thread::get_id()); }, shard);
+    return id.get_future().get();
+}
+} // namespace
+
+TEST(PollerPool, shards_have_their_own_thread)
+{
+    core::PollerPool pool;
+    const auto shard = pool.addShard();
+    EXPECT_NE(shard, core::PollerPool::defaultShard);
+    EXPECT_NE(shardThread(pool, shard),
+              shardThread(pool, core::PollerPool::defaultShard));
+    EXPECT_EQ(shardThread(pool, shard), shardThread(pool, shard));
+}
+
+TEST(PollerPool, slow_shard_does_not_delay_others)
+{
+    std::promise<void> release;
+    auto released = release.get_future();
+    std::promise<void> called;
+    // Destroyed first, the callbacks use the promises.
+    core::PollerPool pool;
+    const auto slow = pool.addShard();
+    const auto fast = pool.addShard();
+
+    pool.post([&released] { released.wait(); }, slow);
+    auto timer = pool.addTimer(1ms, 0ms, [&called] { called.set_value(); },
+                               fast);
+    ASSERT_TRUE(timer);
+    EXPECT_EQ(called.get_future().wait_for(1s), std::future_status::ready);
+    release.set_value();
+}
+
+TEST(PollerPool, remove)
+{
+    core::PollerPool pool;
+    const auto shard = pool.addShard();
+    std::atomic<int> count{0};
+    auto timer = pool.addTimer(1ms, 1ms, [&count] { ++count; }, shard);
+    ASSERT_TRUE(timer);
+    while (count == 0)
+        std::this_thread::sleep_for(1ms);
+
+    pool.remove(*timer).wait();
+    const int stopped = count;
+    std::this_thread::sleep_for(10ms);
+    EXPECT_EQ(count, stopped);
+}
+
+TEST(PollerPool, remove_shard)
+{
+    core::PollerPool pool;
+    const auto first = pool.addShard();
+    pool.removeShard(first);
+    EXPECT_THROW(pool.post([] {}, first), std::out_of_range);
+    EXPECT_THROW(pool.removeShard(core::PollerPool::defaultShard),
+                 std::logic_error);
+    // Reused
+    EXPECT_EQ(pool.addShard(), first);
+}
+
+TEST(PollerPool, thread_options)
+{
+    core::PollerPool pool;
+    const auto shard = pool.addShard();
+    core::ThreadOptions options;
+    options.name = "paddock-test";
+    options.policy = core::ThreadOptions::Policy::background;
+    // Any CPU allowed to the process, CPU 0 may be outside its cpuset.
+    cpu_set_t cpus;
+    ASSERT_EQ(::sched_getaffinity(0, sizeof(cpus), &cpus), 0);
+    for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &cpus))
+        {
+            options.cpus = {static_cast<unsigned int>(cpu)};
+            break;
+        }
+    }
+    ASSERT_FALSE(options.cpus.empty());
+    EXPECT_FALSE(pool.setThreadOptions(shard, options));
+    // Real-time scheduling depends on the privileges of the user.
+}
+
+TEST(PollerPool, thread_options_are_applied_independently)
+{
+    core::PollerPool pool;
+    const auto shard = pool.addShard();
+    core::ThreadOptions options;
+    // Out of the range of SCHED_FIFO, fails with or without privileges.
+    options.policy = core::ThreadOptions::Policy::realTime;
+    options.priority = 0;
+    cpu_set_t cpus;
+    ASSERT_EQ(::sched_getaffinity(0, sizeof(cpus), &cpus), 0);
+    for (int cpu = CPU_SETSIZE - 1; cpu >= 0; --cpu)
+    {
+        if (CPU_ISSET(cpu, &cpus))
+        {
+            options.cpus = {static_cast<unsigned int>(cpu)};
+            break;
+        }
+    }
+    ASSERT_FALSE(options.cpus.empty());
+
+    const auto error = pool.setThreadOptions(shard, options);
+    EXPECT_TRUE(error);
+    EXPECT_TRUE(error.scheduling);
+    EXPECT_FALSE(error.affinity);
+    EXPECT_NE(error.message().find("scheduling"), std::string::npos);
+
+    std::promise<int> count;
+    pool.post(
+        [&count] {
+            cpu_set_t cpus;
+            ::sched_getaffinity(0, sizeof(cpus), &cpus);
+            count.set_value(CPU_COUNT(&cpus));
+        },
+        shard);
+    EXPECT_EQ(count.get_future().get(), 1);
+}
+
+} // namespace paddock
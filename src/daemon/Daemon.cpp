@@ -0,0 +1,522 @@
+#include "paddock/defines.h"
+
+#include "Daemon.hpp"
+
+#include "midi/Engine.hpp"
+#include "midi/errors.hpp"
+#include "midi/pads/KorgPadKontrol.hpp"
+#include "midi/pads/PadSet.hpp"
+#include "midi/pads/korgPadKontrol/Program.hpp"
+
+#include "io/Capture.hpp"
+#include "io/MidiFileRecorder.hpp"
+#include "io/Session.hpp"
+#include "io/korgPadKontrol/Program.hpp"
+
+#include "core/Log.hpp"
+#include "core/errors.hpp"
+
+#include "utils/overloaded.hpp"
+
+#ifdef PADDOCK_USE_LIBLO
+#include "core/NsmSession.hpp"
+#include "io/OscOutput.hpp"
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace paddock::daemon
+{
+namespace
+{
+using namespace std::chrono_literals;
+
+// The HW dev files associated with the input ports may not be ready by the
+// time the system announces the MIDI client.
+constexpr auto deviceRetryDelay = 200ms;
+} // namespace
+
+class Daemon::_Impl
+{
+public:
+    ~_Impl()
+    {
+        // The session manager callbacks may be waiting for requests that
+        // won't be processed anymore.
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+            _tasks.clear();
+            _timers.clear();
+        }
+#ifdef PADDOCK_USE_LIBLO
+        _nsmSession = std::nullopt;
+#endif
+        // The controllers must be destroyed before the engine.
+        _pads = std::nullopt;
+
+        if (_recorder)
+        {
+            if (auto error = _recorder->close())
+                core::log() << error.message();
+        }
+    }
+
+    std::error_code init(const std::optional<midi::EngineBackend>& backend)
+    {
+        auto engine = backend ? midi::Engine::create(*backend)
+                              : midi::Engine::create();
+        if (!engine)
+            return engine.error();
+
+        _engine = std::move(*engine);
+        _pads.emplace(&*_engine, _name);
+        _engine->setEngineEventCallback(
+            [this](const midi::events::EngineEvent& event) {
+                _post([this, event] {
+                    _processEngineEvent(event);
+                    return std::error_code{};
+                });
+            });
+
+#ifdef PADDOCK_USE_LIBLO
+        if (const auto nsmUrl = std::getenv("NSM_URL"))
+        {
+            auto session = core::NsmSession::startNsmSession(
+                nsmUrl,
+                core::NsmSession::Callbacks{
+                    [](bool) {},
+                    [this](const std::string& path, const std::string&,
+                           const std::string& clientId) {
+                        return _call([this, path, clientId] {
+                            _name = clientId;
+                            // Reopened with the new client name.
+                            _pads.emplace(&*_engine, _name);
+                            return open(path);
+                        });
+                    },
+                    [this]() { return _call([this] { return save(); }); }});
+            if (!session)
+                return session.error();
+            _nsmSession = std::move(*session);
+            return std::error_code{};
+        }
+#endif
+        return _connect();
+    }
+
+    bool isNsmSession() const
+    {
+#ifdef PADDOCK_USE_LIBLO
+        return _nsmSession.has_value();
+#else
+        return false;
+#endif
+    }
+
+    std::error_code open(std::string filePath)
+    {
+        _filePath = std::move(filePath);
+
+        core::log() << "Opening session " << _filePath;
+
+        auto session = io::readSession(_filePath);
+        if (!session)
+        {
+            // A new session, it will be created on save.
+            core::log() << session.error().message();
+            _program.clear();
+            return _connect();
+        }
+
+        if (session->model != io::PadModel::korgPadKontrol)
+            return midi::EngineError::noDeviceFound;
+
+        _program = std::move(session->program);
+
+        for (auto& pad : *_pads)
+        {
+            if (auto error = _uploadProgram(pad))
+                return error;
+        }
+        return _connect();
+    }
+
+    std::error_code save()
+    {
+        if (_filePath.empty())
+            return std::make_error_code(std::errc::no_such_file_or_directory);
+        return io::writeSession(_filePath,
+                                {io::PadModel::korgPadKontrol, _program});
+    }
+
+    std::error_code capture(const std::string& filePath)
+    {
+        auto writer = io::CaptureWriter::create(filePath);
+        if (!writer)
+            return writer.error();
+
+        core::log() << "Capturing to " << filePath;
+        _capture = std::make_shared<io::CaptureWriter>(std::move(*writer));
+        for (auto& pad : *_pads)
+            _setTap(pad);
+        return std::error_code{};
+    }
+
+    std::error_code record(const std::string& filePath)
+    {
+        auto recorder = io::MidiFileRecorder::create(
+            filePath, io::MidiFileRecorder::defaultOptions());
+        if (!recorder)
+            return recorder.error();
+
+        core::log() << "Recording to " << filePath;
+        _recorder =
+            std::make_shared<io::MidiFileRecorder>(std::move(*recorder));
+        for (auto& pad : *_pads)
+            _setTap(pad);
+        return std::error_code{};
+    }
+
+    std::error_code sendOsc(const std::vector<std::string>& urls)
+    {
+#ifdef PADDOCK_USE_LIBLO
+        auto output = io::OscOutput::create(urls);
+        if (!output)
+            return output.error();
+
+        core::log() << "Sending OSC to" << urls.size() << "targets";
+        _osc = std::make_shared<io::OscOutput>(std::move(*output));
+        for (auto& pad : *_pads)
+            _setTap(pad);
+        return std::error_code{};
+#else
+        (void)urls;
+        return core::Error::unimplemented;
+#endif
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop)
+        {
+            if (_tasks.empty() && !_timers.empty())
+            {
+                _condition.wait_until(lock, _timers.begin()->first);
+                const auto now = std::chrono::steady_clock::now();
+                while (!_timers.empty() && _timers.begin()->first <= now)
+                {
+                    _tasks.push_back(std::move(_timers.begin()->second));
+                    _timers.erase(_timers.begin());
+                }
+            }
+            else
+            {
+                _condition.wait(lock,
+                                [this] { return _stop || !_tasks.empty(); });
+            }
+
+            while (!_stop && !_tasks.empty())
+            {
+                auto task = std::move(_tasks.front());
+                _tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+    }
+
+    void quit()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_one();
+    }
+
+private:
+    using Task = std::packaged_task<std::error_code()>;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Task> _tasks;
+    std::multimap<std::chrono::steady_clock::time_point, Task> _timers;
+    bool _stop{false};
+
+    std::optional<midi::Engine> _engine;
+    std::optional<midi::PadSet> _pads;
+    // Shared with the taps of the controllers.
+    std::shared_ptr<io::CaptureWriter> _capture;
+    // Each controller is polled from a thread of its own, which records
+    // through an input of its own.
+    std::shared_ptr<io::MidiFileRecorder> _recorder;
+
+    std::string _filePath;
+    /// The program in the binary form, see io::Session
+    std::string _program;
+    std::string _name{"Paddock"};
+
+#ifdef PADDOCK_USE_LIBLO
+    std::optional<core::NsmSession> _nsmSession;
+    std::shared_ptr<io::OscOutput> _osc;
+#endif
+
+    template <typename F>
+    std::future<std::error_code> _post(
+        F&& function,
+        std::chrono::milliseconds delay = std::chrono::milliseconds{0})
+    {
+        Task task{std::forward<F>(function)};
+        auto future = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // Dropping the task breaks the promise of the caller.
+            if (_stop)
+                return future;
+            if (delay.count() == 0)
+                _tasks.push_back(std::move(task));
+            else
+                _timers.emplace(std::chrono::steady_clock::now() + delay,
+                                std::move(task));
+        }
+        _condition.notify_one();
+        return future;
+    }
+
+    /// Runs function in the daemon thread and waits for the result.
+    template <typename F>
+    std::error_code _call(F&& function)
+    {
+        try
+        {
+            return _post(std::forward<F>(function)).get();
+        }
+        catch (const std::future_error&)
+        {
+            return std::make_error_code(std::errc::operation_canceled);
+        }
+    }
+
+    /// Connects all the controllers found that aren't connected yet.
+    std::error_code _connect()
+    {
+        std::error_code firstError;
+        for (auto& pad : _pads->connectAll())
+        {
+            auto error = pad ? _setUp(**pad) : pad.error();
+            if (error && !firstError)
+                firstError = error;
+        }
+        if (_pads->empty())
+            core::log() << "Waiting for a controller";
+        return firstError;
+    }
+
+    std::error_code _connect(const midi::ClientId& client)
+    {
+        const auto info = _engine->queryClientInfo(client);
+        if (!info || info->type == midi::ClientType::user)
+            return midi::EngineError::clientIsNotADevice;
+        for (const auto& port : info->inputs)
+        {
+            if (port.hwDeviceId.empty())
+                return midi::EngineError::deviceNotReady;
+        }
+        for (const auto& port : info->outputs)
+        {
+            if (port.hwDeviceId.empty())
+                return midi::EngineError::deviceNotReady;
+        }
+
+        auto pad = _pads->connect(*info);
+        if (!pad)
+            return pad.error();
+        return _setUp(**pad);
+    }
+
+    std::error_code _setUp(midi::Pad& pad)
+    {
+        auto error = std::visit(
+            [](midi::KorgPadKontrol& pad) {
+                return pad.setMode(midi::KorgPadKontrol::Mode::native);
+            },
+            pad);
+        if (error)
+        {
+            _pads->disconnect(midi::deviceId(pad));
+            return error;
+        }
+        core::log() << "Controller connected," << _pads->size() << "in total";
+        _setTap(pad);
+        return _uploadProgram(pad);
+    }
+
+    void _setTap(midi::Pad& pad)
+    {
+        midi::KorgPadKontrol::Tap tap;
+        if (_capture)
+        {
+            // The pads share the capture, their records are told apart by
+            // the client number of their device.
+            const auto source =
+                io::CaptureSource(midi::deviceId(pad).index);
+            tap.deviceInput = [capture = _capture, source](
+                                  std::span<const std::byte> payload) {
+                capture->recordDeviceInput(payload, source);
+            };
+            tap.clientInput = [capture = _capture, source](
+                                  const midi::events::Event& event) {
+                capture->recordClientInput(event, source);
+            };
+        }
+        if (_recorder)
+        {
+            tap.clientOutput = [input = _recorder->addInput()](
+                                   const midi::events::Event& event) mutable {
+                input.record(event);
+            };
+        }
+
+#ifdef PADDOCK_USE_LIBLO
+        if (_osc)
+        {
+            // Unlike the position in the pad set, the client number is not
+            // given to another pad while this one is connected.
+            const auto controller = int(midi::deviceId(pad).index);
+            tap.deviceEvent = [osc = _osc, controller](
+                                  const midi::korgPadKontrol::Event& event) {
+                osc->send(controller, event);
+            };
+            tap.deviceInputProcessed = [osc = _osc] {
+                if (auto error = osc->flush())
+                    core::log() << error.message();
+            };
+        }
+#endif
+
+        std::visit(
+            [&tap](midi::KorgPadKontrol& pad) { pad.setTap(std::move(tap)); },
+            pad);
+    }
+
+    std::error_code _uploadProgram(midi::Pad& pad)
+    {
+        // A session without program leaves the device scene untouched.
+        if (_program.empty())
+            return std::error_code{};
+
+        // Each controller has its own copy of the program.
+        auto program = io::korgPadKontrol::deserializeProgram(_program);
+        if (!program)
+            return program.error();
+
+        return std::visit(
+            [&program](midi::KorgPadKontrol& pad) {
+                return pad.setProgram(std::move(*program));
+            },
+            pad);
+    }
+
+    void _processEngineEvent(const midi::events::EngineEvent& event)
+    {
+        using namespace midi::events;
+        std::visit(overloaded{[this](const ClientStart& event) {
+                                  _processClientStartEvent(event);
+                              },
+                              [this](const ClientExit& event) {
+                                  if (_pads->disconnect(event.client))
+                                      core::log() << "Controller disconnected";
+                              },
+                              [](auto&&) {}},
+                   event);
+    }
+
+    void _processClientStartEvent(const midi::events::ClientStart& event)
+    {
+        const auto error = _connect(event.client);
+        if (error == midi::EngineError::deviceNotReady)
+        {
+            _post(
+                [this, event] {
+                    _processClientStartEvent(event);
+                    return std::error_code{};
+                },
+                deviceRetryDelay);
+        }
+        else if (error && error != midi::EngineError::clientIsNotADevice &&
+                 error != midi::EngineError::noDeviceFound)
+        {
+            core::log() << error.message();
+        }
+    }
+};
+
+Daemon::Daemon()
+    : _impl{std::make_unique<_Impl>()}
+{
+}
+
+Daemon::~Daemon() = default;
+
+std::error_code Daemon::init()
+{
+    return _impl->init(std::nullopt);
+}
+
+std::error_code Daemon::init(midi::EngineBackend backend)
+{
+    return _impl->init(backend);
+}
+
+bool Daemon::isNsmSession() const
+{
+    return _impl->isNsmSession();
+}
+
+std::error_code Daemon::open(const std::string& filePath)
+{
+    return _impl->open(filePath);
+}
+
+std::error_code Daemon::save()
+{
+    return _impl->save();
+}
+
+std::error_code Daemon::capture(const std::string& filePath)
+{
+    return _impl->capture(filePath);
+}
+
+std::error_code Daemon::record(const std::string& filePath)
+{
+    return _impl->record(filePath);
+}
+
+std::error_code Daemon::sendOsc(const std::vector<std::string>& urls)
+{
+    return _impl->sendOsc(urls);
+}
+
+void Daemon::run()
+{
+    _impl->run();
+}
+
+void Daemon::quit()
+{
+    _impl->quit();
+}
+
+} // namespace paddock::daemon
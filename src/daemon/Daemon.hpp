@@ -0,0 +1,65 @@
+#pragma once
+
+#include "midi/enums.hpp"
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace paddock::daemon
+{
+/// Headless counterpart of paddock::Session.
+///
+/// Plays a session on all the controllers found without any UI. The
+/// controllers are set in native mode and their events are translated by
+/// the session program in the MIDI engine poll thread. Hotplug notifications,
+/// session open and save requests are serialized in the thread that calls
+/// run().
+class Daemon
+{
+public:
+    Daemon();
+    ~Daemon();
+
+    Daemon(const Daemon& other) = delete;
+    Daemon& operator=(const Daemon& other) = delete;
+
+    /// Creates the MIDI engine and announces the daemon to the session
+    /// manager if NSM_URL is set.
+    std::error_code init();
+    /// Same as above with a specific MIDI engine backend, with JACK the
+    /// translated events are sent from JACK MIDI ports.
+    std::error_code init(midi::EngineBackend backend);
+
+    /// True if the session is managed by NSM, which will request the session
+    /// to be opened.
+    bool isNsmSession() const;
+
+    std::error_code open(const std::string& filePath);
+    std::error_code save();
+
+    /// Records the input of all the controllers into a capture file, see
+    /// io::CaptureWriter.
+    std::error_code capture(const std::string& filePath);
+
+    /// Records the events sent by the controllers into a Standard MIDI File
+    /// until the daemon is destroyed.
+    std::error_code record(const std::string& filePath);
+
+    /// Mirrors the events of the controllers as OSC messages to the given
+    /// UDP targets, see io::OscOutput. Requires liblo.
+    std::error_code sendOsc(const std::vector<std::string>& urls);
+
+    /// Processes requests until quit is called.
+    void run();
+
+    /// Can be called from any thread.
+    void quit();
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+};
+
+} // namespace paddock::daemon
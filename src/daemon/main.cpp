@@ -0,0 +1,111 @@
+#include "Daemon.hpp"
+
+#include "core/Globals.hpp"
+
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+int main(int argc, char** argv)
+{
+    auto& globals = paddock::core::Globals::instance();
+    globals.argc = argc;
+    globals.argv = argv;
+
+    const char* captureFile = nullptr;
+    const char* recordFile = nullptr;
+    const char* sessionFile = nullptr;
+    std::vector<std::string> oscTargets;
+    bool useJack = false;
+    bool validArguments = true;
+    for (int i = 1; i != argc && validArguments; ++i)
+    {
+        if (std::string_view{argv[i]} == "--capture" && i + 1 != argc)
+            captureFile = argv[++i];
+        else if (std::string_view{argv[i]} == "--record" && i + 1 != argc)
+            recordFile = argv[++i];
+        else if (std::string_view{argv[i]} == "--osc" && i + 1 != argc)
+            oscTargets.push_back(argv[++i]);
+        else if (std::string_view{argv[i]} == "--jack")
+            useJack = true;
+        else if (!sessionFile && argv[i][0] != '-')
+            sessionFile = argv[i];
+        else
+            validArguments = false;
+    }
+    if (!validArguments)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--jack] [--capture capture file] [--record MIDI file]"
+                     " [--osc URL]... [session file]"
+                  << std::endl;
+        return -1;
+    }
+
+    // The signals are blocked before any thread is started so they are only
+    // delivered to the thread waiting for them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    paddock::daemon::Daemon daemon;
+
+    if (auto error = useJack ? daemon.init(paddock::midi::EngineBackend::jack)
+                             : daemon.init())
+    {
+        std::cerr << error.message() << std::endl;
+        return -1;
+    }
+
+    if (captureFile)
+    {
+        if (auto error = daemon.capture(captureFile))
+        {
+            std::cerr << error.message() << std::endl;
+            return -1;
+        }
+    }
+
+    if (recordFile)
+    {
+        if (auto error = daemon.record(recordFile))
+        {
+            std::cerr << error.message() << std::endl;
+            return -1;
+        }
+    }
+
+    if (!oscTargets.empty())
+    {
+        if (auto error = daemon.sendOsc(oscTargets))
+        {
+            std::cerr << error.message() << std::endl;
+            return -1;
+        }
+    }
+
+    if (sessionFile && !daemon.isNsmSession())
+    {
+        if (auto error = daemon.open(sessionFile))
+        {
+            std::cerr << error.message() << std::endl;
+            return -1;
+        }
+    }
+
+    std::thread signalThread{[&daemon, &signals] {
+        int signal;
+        sigwait(&signals, &signal);
+        daemon.quit();
+    }};
+
+    daemon.run();
+    signalThread.join();
+}
@@ -0,0 +1,426 @@
+#include "Capture.hpp"
+
+#include "files.hpp"
+
+#include "midi/Client.hpp"
+#include "midi/Device.hpp"
+#include "midi/sysex.hpp"
+
+#include "core/errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef Linux
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace paddock::io
+{
+namespace
+{
+constexpr std::array<char, 8> magic{'P', 'D', 'K', 'C', 'A', 'P', 'T', 0};
+// To be increased whenever midi::events::Event changes.
+constexpr uint32_t version = 2;
+
+constexpr size_t alignment = 8;
+// Records waiting to be written beyond this are dropped, the disk is stalled.
+constexpr size_t maxBufferSize = 4 * 1024 * 1024;
+
+struct FileHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t reserved;
+};
+
+enum class RecordType : uint8_t
+{
+    deviceInput = 0,
+    clientInput = 1
+};
+
+struct RecordHeader
+{
+    int64_t time; // ns
+    uint32_t size;
+    RecordType type;
+    CaptureSource source;
+    uint16_t eventIndex;
+};
+
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(RecordHeader) == 16);
+
+size_t paddingOf(size_t size)
+{
+    return (alignment - size % alignment) % alignment;
+}
+
+template <typename T>
+void appendBytes(std::vector<std::byte>& out, const T& value)
+{
+    const auto bytes = reinterpret_cast<const std::byte*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <size_t Index>
+std::optional<midi::events::Event> decodeAlternative(
+    std::span<const std::byte> payload)
+{
+    using T = std::variant_alternative_t<Index, midi::events::Event>;
+    if constexpr (std::is_same_v<T, midi::events::SysEx>)
+    {
+        return midi::events::Event{
+            std::in_place_index<Index>,
+            T{std::vector<std::byte>{payload.begin(), payload.end()}}};
+    }
+    else if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (payload.size() != sizeof(T))
+            return std::nullopt;
+        T event;
+        std::memcpy(&event, payload.data(), sizeof(T));
+        return midi::events::Event{std::in_place_index<Index>, event};
+    }
+    else
+    {
+        return std::nullopt;
+    }
+}
+
+template <size_t... Indices>
+std::optional<midi::events::Event> decodeEvent(
+    size_t index, std::span<const std::byte> payload,
+    std::index_sequence<Indices...>)
+{
+    std::optional<midi::events::Event> event;
+    ((Indices == index ? (void)(event = decodeAlternative<Indices>(payload))
+                       : (void)0),
+     ...);
+    return event;
+}
+
+} // namespace
+
+class CaptureWriter::_Impl
+{
+public:
+    explicit _Impl(int fd)
+        : _fd{fd}
+        , _start{std::chrono::steady_clock::now()}
+        , _thread{[this] { _run(); }}
+    {
+    }
+
+    ~_Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_one();
+        _thread.join();
+#ifdef Linux
+        ::close(_fd);
+#endif
+    }
+
+    void record(RecordType type, CaptureSource source, uint16_t eventIndex,
+                std::span<const std::byte> payload)
+    {
+        const RecordHeader header{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - _start)
+                .count(),
+            static_cast<uint32_t>(payload.size()), type, source, eventIndex};
+        const auto padding = paddingOf(payload.size());
+        const auto size = sizeof(header) + payload.size() + padding;
+
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_error || _buffer.size() + size > maxBufferSize)
+            {
+                ++_dropped;
+                return;
+            }
+            wasEmpty = _buffer.empty();
+            appendBytes(_buffer, header);
+            _buffer.insert(_buffer.end(), payload.begin(), payload.end());
+            _buffer.insert(_buffer.end(), padding, std::byte{0});
+            ++_bufferedRecords;
+        }
+        // Otherwise the writer will find the record when it's done with the
+        // previous ones.
+        if (wasEmpty)
+            _condition.notify_one();
+    }
+
+    size_t droppedRecords() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _dropped;
+    }
+
+    std::error_code error() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _error;
+    }
+
+private:
+    int _fd;
+    std::chrono::steady_clock::time_point _start;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<std::byte> _buffer;
+    size_t _bufferedRecords{0};
+    size_t _dropped{0};
+    std::error_code _error;
+    bool _stop{false};
+
+    // Must be the last member, it uses all the others.
+    std::thread _thread;
+
+    void _run()
+    {
+        // Swapped with the shared buffer, so the producers keep appending
+        // while the records are written.
+        std::vector<std::byte> buffer;
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _condition.wait(lock,
+                            [this] { return _stop || !_buffer.empty(); });
+            // Pending records are written before stopping.
+            if (_buffer.empty())
+                return;
+
+            buffer.clear();
+            std::swap(buffer, _buffer);
+            const auto records = std::exchange(_bufferedRecords, 0);
+            lock.unlock();
+#ifdef Linux
+            const auto error = writeAll(_fd, buffer);
+#else
+            const auto error = std::error_code{core::Error::unimplemented};
+#endif
+            lock.lock();
+            if (error)
+            {
+                _dropped += records;
+                if (!_error)
+                    _error = error;
+            }
+        }
+    }
+};
+
+Expected<CaptureWriter> CaptureWriter::create(const std::string& filePath)
+{
+#ifdef Linux
+    const int fd = ::open(filePath.c_str(),
+                          O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+                          0644);
+    if (fd == -1)
+        return tl::make_unexpected(lastError());
+
+    std::vector<std::byte> header;
+    appendBytes(header, FileHeader{magic, version, 0});
+    if (auto error = writeAll(fd, header))
+    {
+        ::close(fd);
+        return tl::make_unexpected(error);
+    }
+
+    return CaptureWriter{std::make_unique<_Impl>(fd)};
+#else
+    (void)filePath;
+    return tl::make_unexpected(core::Error::unimplemented);
+#endif
+}
+
+CaptureWriter::CaptureWriter(std::unique_ptr<_Impl> impl)
+    : _impl{std::move(impl)}
+{
+}
+
+CaptureWriter::CaptureWriter(CaptureWriter&& other) noexcept = default;
+CaptureWriter& CaptureWriter::operator=(CaptureWriter&& other) noexcept =
+    default;
+
+CaptureWriter::~CaptureWriter() = default;
+
+void CaptureWriter::recordDeviceInput(std::span<const std::byte> payload,
+                                      CaptureSource source)
+{
+    _impl->record(RecordType::deviceInput, source, 0, payload);
+}
+
+void CaptureWriter::recordClientInput(const midi::events::Event& event,
+                                      CaptureSource source)
+{
+    const auto index = static_cast<uint16_t>(event.index());
+    std::visit(
+        [this, source, index](const auto& event) {
+            using T = std::decay_t<decltype(event)>;
+            if constexpr (std::is_same_v<T, midi::events::SysEx>)
+            {
+                _impl->record(RecordType::clientInput, source, index,
+                              event.data);
+            }
+            else if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                _impl->record(RecordType::clientInput, source, index,
+                              std::as_bytes(std::span{&event, 1}));
+            }
+        },
+        event);
+}
+
+size_t CaptureWriter::droppedRecords() const
+{
+    return _impl->droppedRecords();
+}
+
+std::error_code CaptureWriter::error() const
+{
+    return _impl->error();
+}
+
+Expected<CaptureReader> CaptureReader::open(const std::string& filePath)
+{
+    auto file = MappedFile::open(filePath);
+    if (!file)
+        return tl::make_unexpected(file.error());
+
+    const auto data = file->data();
+    FileHeader header;
+    if (data.size() < sizeof(header))
+        return tl::make_unexpected(
+            std::make_error_code(std::errc::invalid_argument));
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != magic || header.version != version)
+        return tl::make_unexpected(
+            std::make_error_code(std::errc::invalid_argument));
+
+    return CaptureReader{std::move(*file)};
+}
+
+CaptureReader::CaptureReader(MappedFile file)
+    : _file{std::move(file)}
+    , _offset{sizeof(FileHeader)}
+{
+}
+
+CaptureReader::CaptureReader(CaptureReader&& other) noexcept = default;
+CaptureReader& CaptureReader::operator=(CaptureReader&& other) noexcept =
+    default;
+
+CaptureReader::~CaptureReader() = default;
+
+std::optional<CaptureRecord> CaptureReader::next()
+{
+    const auto data = std::as_bytes(_file.data());
+    while (data.size() - _offset >= sizeof(RecordHeader))
+    {
+        RecordHeader header;
+        std::memcpy(&header, data.data() + _offset, sizeof(header));
+        if (data.size() - _offset - sizeof(header) < header.size)
+            return std::nullopt;
+
+        const auto payload =
+            data.subspan(_offset + sizeof(header), header.size);
+        _offset = std::min(data.size(), _offset + sizeof(header) +
+                                            header.size +
+                                            paddingOf(header.size));
+
+        const auto time = std::chrono::nanoseconds{header.time};
+        switch (header.type)
+        {
+        case RecordType::deviceInput:
+            return CaptureRecord{time, header.source, payload};
+        case RecordType::clientInput:
+            // Events unknown to this build are skipped.
+            if (auto event = decodeEvent(
+                    header.eventIndex, payload,
+                    std::make_index_sequence<
+                        std::variant_size_v<midi::events::Event>>{}))
+            {
+                return CaptureRecord{time, header.source, std::move(*event)};
+            }
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+void CaptureReader::rewind()
+{
+    _offset = sizeof(FileHeader);
+}
+
+std::error_code replayCapture(
+    CaptureReader& reader,
+    const std::function<std::error_code(const CaptureRecord&)>& sink,
+    double speed)
+{
+    const auto start = std::chrono::steady_clock::now();
+    while (const auto record = reader.next())
+    {
+        if (speed > 0)
+        {
+            std::this_thread::sleep_until(
+                start + std::chrono::duration_cast<
+                            std::chrono::steady_clock::duration>(
+                            record->time / speed));
+        }
+        if (auto error = sink(*record))
+            return error;
+    }
+    return std::error_code{};
+}
+
+std::error_code replayCapture(CaptureReader& reader, midi::Device* device,
+                              midi::Client* client, double speed,
+                              std::optional<CaptureSource> source)
+{
+    std::vector<std::byte> message;
+    return replayCapture(
+        reader,
+        [device, client, source, &message](const CaptureRecord& record) {
+            if (source && record.source != *source)
+                return std::error_code{};
+            if (const auto payload =
+                    std::get_if<std::span<const std::byte>>(&record.data))
+            {
+                if (!device)
+                    return std::error_code{};
+                message.clear();
+                message.push_back(midi::sysex::START);
+                message.insert(message.end(), payload->begin(),
+                               payload->end());
+                message.push_back(midi::sysex::END);
+                const auto written = device->write(message, true);
+                return written ? std::error_code{} : written.error();
+            }
+            if (!client)
+                return std::error_code{};
+            return client->postEvent(
+                std::get<midi::events::Event>(record.data));
+        },
+        speed);
+}
+
+} // namespace paddock::io
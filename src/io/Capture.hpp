@@ -0,0 +1,131 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include "midi/events.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+
+namespace paddock::midi
+{
+class Client;
+class Device;
+} // namespace paddock::midi
+
+namespace paddock::io
+{
+/// Tells apart the controllers recorded in the same capture, e.g. the MIDI
+/// client number of their devices.
+using CaptureSource = uint8_t;
+
+struct CaptureRecord
+{
+    /// Since the capture was created
+    std::chrono::nanoseconds time;
+    CaptureSource source;
+    /// A SysEx payload read from the device without its start and end bytes,
+    /// or an event read from the sequencer client.
+    std::variant<std::span<const std::byte>, midi::events::Event> data;
+};
+
+/// Records the MIDI traffic read from a controller into a capture file.
+///
+/// A capture is a header followed by timestamped records aligned to 8 bytes
+/// in the native byte order, so it can be memory mapped and walked in place.
+/// Events are stored as their alternative index in midi::events::Event and
+/// their bytes, which ties the files to the build that wrote them.
+///
+/// Records are copied into a buffer and written to the file by a background
+/// thread, recording never blocks on disk access and can be done from any
+/// thread.
+class CaptureWriter
+{
+public:
+    /// Replaces the file if it exists.
+    static Expected<CaptureWriter> create(const std::string& filePath);
+
+    CaptureWriter(CaptureWriter&& other) noexcept;
+    CaptureWriter& operator=(CaptureWriter&& other) noexcept;
+
+    CaptureWriter(const CaptureWriter& other) = delete;
+    CaptureWriter& operator=(const CaptureWriter& other) = delete;
+
+    /// Writes the records buffered.
+    ~CaptureWriter();
+
+    void recordDeviceInput(std::span<const std::byte> payload,
+                           CaptureSource source = 0);
+    /// Events that can't be stored, like user events with pointers, are
+    /// skipped.
+    void recordClientInput(const midi::events::Event& event,
+                           CaptureSource source = 0);
+
+    /// Records dropped because the disk didn't keep up or failed.
+    size_t droppedRecords() const;
+
+    /// The first error writing the file, the records are dropped after it.
+    std::error_code error() const;
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+
+    CaptureWriter(std::unique_ptr<_Impl> impl);
+};
+
+class CaptureReader
+{
+public:
+    /// @return std::errc::invalid_argument if the file isn't a capture
+    static Expected<CaptureReader> open(const std::string& filePath);
+
+    CaptureReader(CaptureReader&& other) noexcept;
+    CaptureReader& operator=(CaptureReader&& other) noexcept;
+
+    CaptureReader(const CaptureReader& other) = delete;
+    CaptureReader& operator=(const CaptureReader& other) = delete;
+
+    ~CaptureReader();
+
+    /// The payloads point into the mapped file, they are valid while the
+    /// reader exists.
+    /// @return std::nullopt at the end of the capture or at a record torn
+    /// by a crash
+    std::optional<CaptureRecord> next();
+
+    void rewind();
+
+private:
+    MappedFile _file;
+    size_t _offset;
+
+    CaptureReader(MappedFile file);
+};
+
+/// Feeds the records of a capture to sink with their original timing
+/// divided by speed, or as fast as possible if speed is 0.
+/// @return the first error returned by sink, which stops the replay
+std::error_code replayCapture(
+    CaptureReader& reader,
+    const std::function<std::error_code(const CaptureRecord&)>& sink,
+    double speed = 1);
+
+/// Writes the device records to device, e.g. a virtual raw MIDI port paddock
+/// reads from, and posts the client records through client. Any of them can
+/// be null to skip its records.
+/// @param source only replays the records of this controller if set, the
+/// records of several controllers would be mixed otherwise
+std::error_code replayCapture(
+    CaptureReader& reader, midi::Device* device, midi::Client* client,
+    double speed = 1, std::optional<CaptureSource> source = std::nullopt);
+
+} // namespace paddock::io
@@ -0,0 +1,102 @@
+#include "DeviceStates.hpp"
+
+#include "MappedFile.hpp"
+#include "errors.hpp"
+#include "files.hpp"
+
+#include "utils/encodings.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace paddock::io
+{
+using json = nlohmann::json;
+
+namespace
+{
+Expected<std::string> decode(const json& in)
+{
+    if (!in.is_string())
+        return tl::make_unexpected(SerializationError::invalidDocument);
+    const auto bytes = fromBase64(in.get_ref<const std::string&>());
+    if (!bytes)
+        return tl::make_unexpected(SerializationError::invalidDocument);
+    return std::string(reinterpret_cast<const char*>(bytes->data()),
+                       bytes->size());
+}
+} // namespace
+
+std::string DeviceStates::filePath(const std::string& sessionFilePath)
+{
+    return sessionFilePath + ".devices";
+}
+
+Expected<DeviceStates> DeviceStates::read(const std::string& filePath)
+{
+    DeviceStates states;
+
+    const auto file = MappedFile::open(filePath);
+    if (!file)
+    {
+        if (file.error() == std::errc::no_such_file_or_directory)
+            return states;
+        return tl::make_unexpected(file.error());
+    }
+
+    const auto data = file->data();
+    const auto document = json::parse(data.begin(), data.end(), nullptr,
+                                      /* allow_exceptions */ false);
+    const auto devices = document.find("devices");
+    if (!document.is_object() || devices == document.end() ||
+        !devices->is_array())
+    {
+        return tl::make_unexpected(SerializationError::invalidDocument);
+    }
+
+    for (const auto& device : *devices)
+    {
+        if (!device.is_object() || !device.contains("identity") ||
+            !device.contains("scene"))
+        {
+            return tl::make_unexpected(SerializationError::invalidDocument);
+        }
+        // The identity is kept in its encoded form, but it must be valid.
+        const auto identity = decode(device["identity"]);
+        auto scene = decode(device["scene"]);
+        if (!identity || !scene)
+            return tl::make_unexpected(SerializationError::invalidDocument);
+        states._scenes[device["identity"].get<std::string>()] =
+            std::move(*scene);
+    }
+    return states;
+}
+
+std::error_code DeviceStates::write(const std::string& filePath) const
+{
+    auto devices = json::array();
+    for (const auto& [identity, scene] : _scenes)
+    {
+        json device;
+        device["identity"] = identity;
+        device["scene"] = toBase64(std::as_bytes(std::span{scene}));
+        devices.push_back(std::move(device));
+    }
+    json document;
+    document["devices"] = std::move(devices);
+    return writeFileAtomically(filePath, document.dump(4) + '\n');
+}
+
+const std::string* DeviceStates::scene(
+    std::span<const std::byte> identity) const
+{
+    const auto state = _scenes.find(toBase64(identity));
+    return state == _scenes.end() ? nullptr : &state->second;
+}
+
+void DeviceStates::setScene(std::span<const std::byte> identity,
+                            std::string scene)
+{
+    _scenes[toBase64(identity)] = std::move(scene);
+}
+
+} // namespace paddock::io
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "utils/Expected.hpp"
+
+#include <cstddef>
+#include <map>
+#include <span>
+#include <string>
+#include <system_error>
+
+namespace paddock::io
+{
+/// Last known state of the devices used in a session, keyed by the identity
+/// reply of each device.
+///
+/// It's stored next to the session file, so a device that is reconnected
+/// doesn't need to be queried for the state it had when it was unplugged.
+class DeviceStates
+{
+public:
+    /// @return the path of the file with the states of a session
+    static std::string filePath(const std::string& sessionFilePath);
+
+    /// A missing file is an empty set of states.
+    static Expected<DeviceStates> read(const std::string& filePath);
+    /// The file is replaced atomically, see io::writeFileAtomically
+    std::error_code write(const std::string& filePath) const;
+
+    /// @return the scene in binary form (e.g. as returned by
+    /// io::korgPadKontrol::serializeScene) or nullptr if unknown
+    const std::string* scene(std::span<const std::byte> identity) const;
+    void setScene(std::span<const std::byte> identity, std::string scene);
+
+    bool empty() const { return _scenes.empty(); }
+
+private:
+    // Keyed by the base64 form of the identity
+    std::map<std::string, std::string> _scenes;
+};
+
+} // namespace paddock::io
@@ -0,0 +1,279 @@
+#include "Journal.hpp"
+
+#include "MappedFile.hpp"
+#include "files.hpp"
+
+#include "core/errors.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#ifdef Linux
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace paddock::io
+{
+namespace
+{
+// Records are framed as a little endian 32-bit payload size, the CRC-32 of
+// the payload and the payload.
+constexpr size_t frameHeaderSize = 8;
+
+constexpr auto crcTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i != 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit != 8; ++bit)
+            crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+        table[i] = crc;
+    }
+    return table;
+}();
+
+uint32_t crc32(std::string_view data)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (auto c : data)
+        crc = (crc >> 8) ^
+              crcTable[(crc ^ static_cast<unsigned char>(c)) & 0xFF];
+    return crc ^ 0xFFFFFFFF;
+}
+
+void appendUint32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i != 4; ++i)
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+uint32_t readUint32(std::string_view in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i != 4; ++i)
+        value |= uint32_t(static_cast<unsigned char>(in[i])) << (i * 8);
+    return value;
+}
+
+std::string makeFrame(std::string_view record)
+{
+    std::string frame;
+    frame.reserve(frameHeaderSize + record.size());
+    appendUint32(frame, static_cast<uint32_t>(record.size()));
+    appendUint32(frame, crc32(record));
+    frame.append(record);
+    return frame;
+}
+
+/// @return the offset past the last valid record
+size_t readRecords(std::string_view data, std::vector<std::string>& records)
+{
+    size_t offset = 0;
+    while (data.size() - offset >= frameHeaderSize)
+    {
+        const auto header = data.substr(offset, frameHeaderSize);
+        const auto size = readUint32(header);
+        if (data.size() - offset - frameHeaderSize < size)
+            break;
+        const auto record = data.substr(offset + frameHeaderSize, size);
+        if (crc32(record) != readUint32(header.substr(4)))
+            break;
+        records.emplace_back(record);
+        offset += frameHeaderSize + size;
+    }
+    return offset;
+}
+
+} // namespace
+
+class Journal::_Impl
+{
+public:
+    _Impl(std::string sessionFilePath, int fd, std::vector<std::string> records)
+        : _sessionFilePath{std::move(sessionFilePath)}
+        , _fd{fd}
+        , _pendingRecords{std::move(records)}
+        , _recordCount{_pendingRecords.size()}
+        , _thread{[this] { _run(); }}
+    {
+    }
+
+    ~_Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_one();
+        _thread.join();
+#ifdef Linux
+        ::close(_fd);
+#endif
+    }
+
+    const std::vector<std::string>& pendingRecords() const
+    {
+        return _pendingRecords;
+    }
+
+    size_t recordCount() const { return _recordCount; }
+
+    std::future<std::error_code> append(std::string record)
+    {
+        ++_recordCount;
+        return _post([this, frame = makeFrame(record)] {
+#ifdef Linux
+            if (auto error = writeAll(_fd, std::as_bytes(std::span{frame})))
+                return error;
+            if (::fdatasync(_fd) == -1)
+                return lastError();
+            return std::error_code{};
+#else
+            return std::error_code{core::Error::unimplemented};
+#endif
+        });
+    }
+
+    std::future<std::error_code> compact(std::string document)
+    {
+        _recordCount = 0;
+        return _post([this, document = std::move(document)] {
+            if (auto error = writeFileAtomically(_sessionFilePath, document))
+                return error;
+#ifdef Linux
+            // A crash before this point replays records that are already
+            // in the session file, which is harmless.
+            if (::ftruncate(_fd, 0) == -1)
+                return lastError();
+#endif
+            return std::error_code{};
+        });
+    }
+
+private:
+    using Task = std::packaged_task<std::error_code()>;
+
+    std::string _sessionFilePath;
+    int _fd;
+    std::vector<std::string> _pendingRecords;
+    std::atomic<size_t> _recordCount;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<Task> _tasks;
+    bool _stop{false};
+
+    // Must be the last member, it uses all the others.
+    std::thread _thread;
+
+    template <typename F>
+    std::future<std::error_code> _post(F&& function)
+    {
+        Task task{std::forward<F>(function)};
+        auto future = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _condition.notify_one();
+        return future;
+    }
+
+    void _run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+            // Pending work is finished before stopping.
+            if (_tasks.empty())
+                return;
+
+            auto task = std::move(_tasks.front());
+            _tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+};
+
+Expected<Journal> Journal::open(const std::string& sessionFilePath)
+{
+#ifdef Linux
+    const auto journalPath = sessionFilePath + ".journal";
+
+    std::vector<std::string> records;
+    size_t validSize = 0;
+    if (auto file = MappedFile::open(journalPath))
+    {
+        const auto data = file->data();
+        validSize =
+            readRecords(std::string_view{data.data(), data.size()}, records);
+    }
+    else if (file.error() != std::errc::no_such_file_or_directory)
+    {
+        return tl::make_unexpected(file.error());
+    }
+
+    const int fd = ::open(journalPath.c_str(),
+                          O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return tl::make_unexpected(lastError());
+
+    // Drop a record torn by a crash, otherwise the new records would be
+    // appended after it and never be read back.
+    if (::ftruncate(fd, static_cast<off_t>(validSize)) == -1)
+    {
+        const auto error = lastError();
+        ::close(fd);
+        return tl::make_unexpected(error);
+    }
+
+    return Journal{
+        std::make_unique<_Impl>(sessionFilePath, fd, std::move(records))};
+#else
+    (void)sessionFilePath;
+    return tl::make_unexpected(core::Error::unimplemented);
+#endif
+}
+
+Journal::Journal(std::unique_ptr<_Impl> impl)
+    : _impl{std::move(impl)}
+{
+}
+
+Journal::Journal(Journal&& other) noexcept = default;
+Journal& Journal::operator=(Journal&& other) noexcept = default;
+
+Journal::~Journal() = default;
+
+const std::vector<std::string>& Journal::pendingRecords() const
+{
+    return _impl->pendingRecords();
+}
+
+size_t Journal::recordCount() const
+{
+    return _impl->recordCount();
+}
+
+std::future<std::error_code> Journal::append(std::string record)
+{
+    return _impl->append(std::move(record));
+}
+
+std::future<std::error_code> Journal::compact(std::string document)
+{
+    return _impl->compact(std::move(document));
+}
+
+} // namespace paddock::io
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "utils/Expected.hpp"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddock::io
+{
+/// Append-only journal of edits for a session file, written from a
+/// background thread.
+///
+/// Each record is an opaque snapshot (e.g. a serialized program) appended to
+/// <session file>.journal and synced to disk. Compaction atomically replaces
+/// the session file with a full document and empties the journal. On start
+/// up, the records that weren't compacted yet can be replayed on top of the
+/// session file. A record torn by a crash is detected by its checksum and
+/// discarded.
+///
+/// Operations are queued and run in order in the I/O thread, the calls
+/// never block on disk access and can be made from any thread.
+class Journal
+{
+public:
+    /// Opens the journal of a session file, creating it if needed, and reads
+    /// the pending records.
+    static Expected<Journal> open(const std::string& sessionFilePath);
+
+    Journal(Journal&& other) noexcept;
+    Journal& operator=(Journal&& other) noexcept;
+
+    Journal(const Journal& other) = delete;
+    Journal& operator=(const Journal& other) = delete;
+
+    /// Waits for the queued operations to finish.
+    ~Journal();
+
+    /// The records found in the journal when it was opened, oldest first.
+    const std::vector<std::string>& pendingRecords() const;
+
+    /// The number of records appended since the last compaction, including
+    /// the pending ones.
+    size_t recordCount() const;
+
+    /// @return a future with the result of writing the record
+    std::future<std::error_code> append(std::string record);
+
+    /// Replaces the session file with document and truncates the journal.
+    /// @return a future with the result of writing the session file
+    std::future<std::error_code> compact(std::string document);
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+
+    Journal(std::unique_ptr<_Impl> impl);
+};
+
+} // namespace paddock::io
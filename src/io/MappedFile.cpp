@@ -0,0 +1,85 @@
+#include "MappedFile.hpp"
+
+#include "files.hpp"
+
+#include "core/errors.hpp"
+
+#include <utility>
+
+#ifdef Linux
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace paddock::io
+{
+Expected<MappedFile> MappedFile::open(const std::string& filePath)
+{
+#ifdef Linux
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return tl::make_unexpected(lastError());
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1)
+    {
+        const auto error = lastError();
+        ::close(fd);
+        return tl::make_unexpected(error);
+    }
+
+    const auto size = static_cast<size_t>(status.st_size);
+    if (size == 0)
+    {
+        // Empty files can't be mapped.
+        ::close(fd);
+        return MappedFile{nullptr, 0};
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const auto error = data == MAP_FAILED ? lastError() : std::error_code{};
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (error)
+        return tl::make_unexpected(error);
+
+    // The file is read front to back once.
+    ::madvise(data, size, MADV_SEQUENTIAL);
+
+    return MappedFile{static_cast<const char*>(data), size};
+#else
+    (void)filePath;
+    return tl::make_unexpected(core::Error::unimplemented);
+#endif
+}
+
+MappedFile::MappedFile(const char* data, size_t size)
+    : _data{data}
+    , _size{size}
+{
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data{std::exchange(other._data, nullptr)}
+    , _size{std::exchange(other._size, 0)}
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef Linux
+    if (_data)
+        ::munmap(const_cast<char*>(_data), _size);
+#endif
+}
+
+} // namespace paddock::io
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "utils/Expected.hpp"
+
+#include <span>
+#include <string>
+
+namespace paddock::io
+{
+/// A read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+    /// @return the errno of the failing system call as std::errc
+    static Expected<MappedFile> open(const std::string& filePath);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    ~MappedFile();
+
+    std::span<const char> data() const { return {_data, _size}; }
+
+private:
+    const char* _data{nullptr};
+    size_t _size{0};
+
+    MappedFile(const char* data, size_t size);
+};
+
+} // namespace paddock::io
@@ -0,0 +1,431 @@
+#include "MidiFileRecorder.hpp"
+
+#include "files.hpp"
+
+#include "core/errors.hpp"
+
+#include "midi/messages.hpp"
+
+#include "utils/SpscQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifdef Linux
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace paddock::io
+{
+namespace
+{
+// ~15 s of events at the maximum rate of a MIDI cable.
+constexpr size_t queueCapacity = 16384;
+constexpr auto writePeriod = std::chrono::milliseconds{100};
+constexpr size_t outputBufferSize = 64 * 1024;
+// The largest delta time that fits in a variable length quantity.
+constexpr uint32_t maxDeltaTime = 0x0FFFFFFF;
+
+struct Message
+{
+    int64_t time; // ns
+    midi::ShortMessage message;
+};
+
+/// Big endian, as all the SMF numbers.
+template <typename T>
+void appendNumber(std::vector<uint8_t>& out, T value, size_t size = sizeof(T))
+{
+    for (size_t i = size; i != 0; --i)
+        out.push_back(uint8_t(value >> ((i - 1) * 8)));
+}
+
+void appendVariableLength(std::vector<uint8_t>& out, uint32_t value)
+{
+    std::array<uint8_t, 4> bytes;
+    size_t count = 0;
+    do
+    {
+        bytes[count++] = value & 0x7F;
+        value >>= 7;
+    } while (value != 0);
+    while (count != 0)
+    {
+        --count;
+        out.push_back(bytes[count] | (count != 0 ? 0x80 : 0));
+    }
+}
+
+void appendTempoAndSignature(std::vector<uint8_t>& out,
+                             const MidiFileRecorder::Options& options)
+{
+    out.insert(out.end(), {0x00, 0xFF, 0x51, 0x03});
+    appendNumber(out, options.tempo.microsecsPerQuaterNote, 3);
+    const auto& signature = options.timeSignature;
+    out.insert(out.end(), {0x00, 0xFF, 0x58, 0x04,
+                           uint8_t(signature.numerator),
+                           uint8_t(signature.denominator),
+                           uint8_t(signature.ticksPerClick),
+                           uint8_t(signature.notesPerQuaterNote)});
+}
+
+void appendEndOfTrack(std::vector<uint8_t>& out)
+{
+    out.insert(out.end(), {0x00, 0xFF, 0x2F, 0x00});
+}
+
+void appendTrackHeader(std::vector<uint8_t>& out, uint32_t size)
+{
+    out.insert(out.end(), {'M', 'T', 'r', 'k'});
+    appendNumber(out, size);
+}
+
+} // namespace
+
+class MidiFileRecorder::Input::_Impl
+{
+public:
+    explicit _Impl(std::chrono::steady_clock::time_point start)
+        : _start{start}
+    {
+    }
+
+    void record(const midi::events::Event& event)
+    {
+        const auto encoded = midi::encodeShortMessage(event);
+        if (!encoded)
+            return;
+        Message message{0, *encoded};
+        message.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - _start)
+                           .count();
+        if (_failed.load(std::memory_order_relaxed) || !_queue.push(message))
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Only from the writer thread
+    std::optional<Message> pop() { return _queue.pop(); }
+
+    size_t droppedEvents() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    /// The events recorded from now on are dropped.
+    void fail() { _failed.store(true, std::memory_order_relaxed); }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+    SpscQueue<Message> _queue{queueCapacity};
+    std::atomic<size_t> _dropped{0};
+    std::atomic<bool> _failed{false};
+};
+
+class MidiFileRecorder::_Impl
+{
+public:
+    _Impl(int fd, const Options& options, uint32_t lengthOffset,
+          uint32_t trackSize)
+        : _fd{fd}
+        , _options{options}
+        , _lengthOffset{lengthOffset}
+        , _trackSize{trackSize}
+        , _start{std::chrono::steady_clock::now()}
+        , _input{std::make_shared<Input::_Impl>(_start)}
+        , _inputs{_input}
+        , _thread{[this] { _run(); }}
+    {
+    }
+
+    ~_Impl() { close(); }
+
+    void record(const midi::events::Event& event) { _input->record(event); }
+
+    std::shared_ptr<Input::_Impl> addInput()
+    {
+        auto input = std::make_shared<Input::_Impl>(_start);
+        std::lock_guard<std::mutex> lock(_inputsMutex);
+        if (_failed)
+            input->fail();
+        _inputs.push_back(input);
+        return input;
+    }
+
+    size_t droppedEvents() const
+    {
+        std::lock_guard<std::mutex> lock(_inputsMutex);
+        size_t dropped = _releasedDropped;
+        for (const auto& input : _inputs)
+            dropped += input->droppedEvents();
+        return dropped;
+    }
+
+    std::error_code close()
+    {
+        if (!_thread.joinable())
+            return _error;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_one();
+        _thread.join();
+
+#ifdef Linux
+        appendEndOfTrack(_out);
+        _flush();
+        if (!_error)
+        {
+            std::vector<uint8_t> length;
+            appendNumber(length, _trackSize);
+            if (::pwrite(_fd, length.data(), length.size(), _lengthOffset) !=
+                ssize_t(length.size()))
+            {
+                _error = lastError();
+            }
+        }
+        if (::close(_fd) == -1 && !_error)
+            _error = lastError();
+#endif
+        return _error;
+    }
+
+private:
+    int _fd;
+    Options _options;
+    uint32_t _lengthOffset;
+    uint32_t _trackSize;
+    std::chrono::steady_clock::time_point _start;
+
+    // The one of record
+    std::shared_ptr<Input::_Impl> _input;
+
+    // The producers never take it, only addInput and the writer thread.
+    mutable std::mutex _inputsMutex;
+    std::vector<std::shared_ptr<Input::_Impl>> _inputs;
+    // Of the inputs already released
+    size_t _releasedDropped{0};
+    bool _failed{false};
+
+    // Only used by the writer thread until it's joined.
+    std::vector<std::shared_ptr<Input::_Impl>> _drained;
+    std::vector<Message> _messages;
+    std::vector<uint8_t> _out;
+    uint64_t _lastTick{0};
+    std::error_code _error;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop{false};
+
+    // Must be the last member, it uses all the others.
+    std::thread _thread;
+
+    void _run()
+    {
+        _out.reserve(outputBufferSize);
+
+        // The events are written in batches, waking up the writer on each
+        // event would cost a system call in the MIDI thread.
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _condition.wait_for(lock, writePeriod, [this] { return _stop; });
+            const bool stop = _stop;
+            lock.unlock();
+            _writeQueued();
+            if (stop)
+                return;
+            lock.lock();
+        }
+    }
+
+    void _writeQueued()
+    {
+        // ns per tick = tempo (us per quarter note) * 1000 / ticks per
+        // quarter note
+        const auto ticksPerQuarterNote = _options.ticksPerQuarterNote;
+        const auto nsPerQuarterNote =
+            int64_t(_options.tempo.microsecsPerQuaterNote) * 1000;
+
+        // The inputs only held by the list and the copy have no owner left,
+        // they are drained a last time.
+        {
+            std::lock_guard<std::mutex> lock(_inputsMutex);
+            _drained = _inputs;
+            std::erase_if(_inputs, [this](const auto& input) {
+                if (input.use_count() != 2)
+                    return false;
+                _releasedDropped += input->droppedEvents();
+                return true;
+            });
+        }
+        _messages.clear();
+        for (const auto& input : _drained)
+        {
+            while (auto message = input->pop())
+                _messages.push_back(*message);
+        }
+        _drained.clear();
+        // Each queue is in time order, not the messages of several ones.
+        std::stable_sort(_messages.begin(), _messages.end(),
+                         [](const Message& a, const Message& b) {
+                             return a.time < b.time;
+                         });
+
+        for (const auto& message : _messages)
+        {
+            const auto tick = uint64_t(message.time) * ticksPerQuarterNote /
+                              uint64_t(nsPerQuarterNote);
+            const auto delta = tick > _lastTick ? tick - _lastTick : 0;
+            _lastTick = std::max(tick, _lastTick);
+
+            // A delta time, a message and the end of track always fit.
+            if (_out.size() + 16 > outputBufferSize)
+                _flush();
+            appendVariableLength(_out, uint32_t(std::min<uint64_t>(
+                                           delta, maxDeltaTime)));
+            const auto& data = message.message.data;
+            _out.insert(_out.end(), data.begin(),
+                        data.begin() + message.message.size);
+        }
+        _flush();
+    }
+
+    void _fail()
+    {
+        std::lock_guard<std::mutex> lock(_inputsMutex);
+        _failed = true;
+        for (const auto& input : _inputs)
+            input->fail();
+    }
+
+    void _flush()
+    {
+        if (_out.empty())
+            return;
+        _trackSize += uint32_t(_out.size());
+#ifdef Linux
+        if (!_error)
+            _error = writeAll(_fd, std::as_bytes(std::span{_out}));
+#else
+        _error = core::Error::unimplemented;
+#endif
+        if (_error)
+            _fail();
+        _out.clear();
+    }
+};
+
+MidiFileRecorder::Options MidiFileRecorder::defaultOptions()
+{
+    return Options{Format::singleTrack,
+                   960,
+                   {500000},
+                   {std::byte{4}, std::byte{2}, std::byte{24}, std::byte{8}}};
+}
+
+Expected<MidiFileRecorder> MidiFileRecorder::create(
+    const std::string& filePath, const Options& options)
+{
+    if (options.ticksPerQuarterNote == 0 ||
+        options.ticksPerQuarterNote > 0x7FFF ||
+        options.tempo.microsecsPerQuaterNote == 0 ||
+        options.tempo.microsecsPerQuaterNote > 0xFFFFFF)
+    {
+        return tl::make_unexpected(
+            std::make_error_code(std::errc::invalid_argument));
+    }
+
+#ifdef Linux
+    std::vector<uint8_t> header;
+    header.insert(header.end(), {'M', 'T', 'h', 'd'});
+    appendNumber(header, uint32_t(6));
+    appendNumber(header, uint16_t(options.format));
+    appendNumber(header,
+                 uint16_t(options.format == Format::singleTrack ? 1 : 2));
+    appendNumber(header, options.ticksPerQuarterNote);
+
+    std::vector<uint8_t> track;
+    appendTempoAndSignature(track, options);
+    if (options.format == Format::multiTrack)
+    {
+        appendEndOfTrack(track);
+        appendTrackHeader(header, uint32_t(track.size()));
+        header.insert(header.end(), track.begin(), track.end());
+        track.clear();
+    }
+    appendTrackHeader(header, 0);
+    const auto lengthOffset = uint32_t(header.size() - 4);
+    header.insert(header.end(), track.begin(), track.end());
+
+    const int fd = ::open(filePath.c_str(),
+                          O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return tl::make_unexpected(lastError());
+    if (auto error = writeAll(fd, std::as_bytes(std::span{header})))
+    {
+        ::close(fd);
+        return tl::make_unexpected(error);
+    }
+
+    return MidiFileRecorder{std::make_unique<_Impl>(
+        fd, options, lengthOffset, uint32_t(track.size()))};
+#else
+    (void)filePath;
+    return tl::make_unexpected(core::Error::unimplemented);
+#endif
+}
+
+MidiFileRecorder::MidiFileRecorder(std::unique_ptr<_Impl> impl)
+    : _impl{std::move(impl)}
+{
+}
+
+MidiFileRecorder::MidiFileRecorder(MidiFileRecorder&& other) noexcept =
+    default;
+MidiFileRecorder& MidiFileRecorder::operator=(
+    MidiFileRecorder&& other) noexcept = default;
+
+MidiFileRecorder::~MidiFileRecorder() = default;
+
+void MidiFileRecorder::record(const midi::events::Event& event)
+{
+    _impl->record(event);
+}
+
+MidiFileRecorder::Input MidiFileRecorder::addInput()
+{
+    return Input{_impl->addInput()};
+}
+
+MidiFileRecorder::Input::Input(std::shared_ptr<_Impl> impl)
+    : _impl{std::move(impl)}
+{
+}
+
+void MidiFileRecorder::Input::record(const midi::events::Event& event)
+{
+    _impl->record(event);
+}
+
+size_t MidiFileRecorder::droppedEvents() const
+{
+    return _impl->droppedEvents();
+}
+
+std::error_code MidiFileRecorder::close()
+{
+    return _impl->close();
+}
+
+} // namespace paddock::io
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "midi/events.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace paddock::io
+{
+/// Records MIDI events into a Standard MIDI File as they happen.
+///
+/// The events are stamped and queued without allocating nor blocking, a
+/// background thread encodes them and appends them to the file. The length
+/// of the track is patched when the recorder is closed, a file that wasn't
+/// closed has a zero length track that most readers reject.
+class MidiFileRecorder
+{
+public:
+    /// A queue of its own for another thread that records, e.g. the MIDI
+    /// thread of each controller, so they never wait for each other. The
+    /// events of all the inputs are written to the same track in time order.
+    class Input
+    {
+    public:
+        /// Only voice and channel events are recorded, the others are
+        /// ignored. Must be called from one thread at a time.
+        void record(const midi::events::Event& event);
+
+    private:
+        friend class MidiFileRecorder;
+        class _Impl;
+        std::shared_ptr<_Impl> _impl;
+
+        explicit Input(std::shared_ptr<_Impl> impl);
+    };
+
+    enum class Format : uint16_t
+    {
+        singleTrack = 0,
+        /// The tempo and time signature in a track of their own.
+        multiTrack = 1
+    };
+
+    struct Options
+    {
+        Format format;
+        uint16_t ticksPerQuarterNote;
+        midi::events::Tempo tempo;
+        midi::events::TimeSignature timeSignature;
+    };
+
+    /// Type 0 file at 120 bpm in 4/4 with 960 ticks per quarter note.
+    static Options defaultOptions();
+
+    /// Replaces the file if it exists.
+    static Expected<MidiFileRecorder> create(const std::string& filePath,
+                                             const Options& options);
+
+    MidiFileRecorder(MidiFileRecorder&& other) noexcept;
+    MidiFileRecorder& operator=(MidiFileRecorder&& other) noexcept;
+
+    MidiFileRecorder(const MidiFileRecorder& other) = delete;
+    MidiFileRecorder& operator=(const MidiFileRecorder& other) = delete;
+
+    /// Closes the file if it's still open.
+    ~MidiFileRecorder();
+
+    /// Only voice and channel events are recorded, the others are ignored.
+    /// Must be called from one thread at a time, e.g. the MIDI thread.
+    void record(const midi::events::Event& event);
+
+    /// Can be called from any thread. The queue of the input is released
+    /// once the input is destroyed and its events written.
+    Input addInput();
+
+    /// Events dropped because the queue was full or the file failed.
+    size_t droppedEvents() const;
+
+    /// Writes the queued events, ends the track and patches its length.
+    /// @return the first error found writing the file
+    std::error_code close();
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+
+    MidiFileRecorder(std::unique_ptr<_Impl> impl);
+};
+
+} // namespace paddock::io
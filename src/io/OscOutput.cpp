@@ -0,0 +1,183 @@
+#include "OscOutput.hpp"
+
+#include "utils/overloaded.hpp"
+
+#include <lo/lo.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace paddock::io
+{
+namespace
+{
+struct StagedEvent
+{
+    int controller;
+    midi::korgPadKontrol::Event event;
+};
+
+using AddressHandle = std::unique_ptr<void, void (*)(lo_address)>;
+
+lo_message makeMessage(std::initializer_list<int> arguments)
+{
+    lo_message message = lo_message_new();
+    for (const auto argument : arguments)
+        lo_message_add_int32(message, argument);
+    return message;
+}
+
+void addMessage(lo_bundle bundle, const StagedEvent& staged)
+{
+    using namespace midi::korgPadKontrol;
+    const int controller = staged.controller;
+    std::visit(
+        overloaded{
+            [&](const events::PadOutput& e) {
+                lo_bundle_add_message(
+                    bundle, "/paddock/pad",
+                    makeMessage({controller, e.number, e.velocity, e.on}));
+            },
+            [&](const events::KnobOutput& e) {
+                lo_bundle_add_message(
+                    bundle, "/paddock/knob",
+                    makeMessage({controller, int(e.knob), e.value}));
+            },
+            [&](const events::XyOutput& e) {
+                lo_bundle_add_message(bundle, "/paddock/xy",
+                                      makeMessage({controller, e.x, e.y}));
+            },
+            [&](const events::WheelOutput& e) {
+                lo_bundle_add_message(
+                    bundle, "/paddock/wheel",
+                    makeMessage({controller,
+                                 e.turn == WheelTurn::clockwise ? 1 : -1}));
+            },
+            [&](const events::PedalOutput& e) {
+                lo_bundle_add_message(bundle, "/paddock/pedal",
+                                      makeMessage({controller, e.data}));
+            },
+            [&](const events::SwitchOutput& e) {
+                lo_bundle_add_message(
+                    bundle, "/paddock/switch",
+                    makeMessage({controller, int(e.name), e.pressed}));
+            }},
+        staged.event);
+}
+} // namespace
+
+class OscOutput::_Impl
+{
+public:
+    _Impl(std::vector<AddressHandle> targets)
+        : _targets{std::move(targets)}
+    {
+        _staged.reserve(maxEventsPerBundle);
+        _sending.reserve(maxEventsPerBundle);
+    }
+
+    void send(int controller, const midi::korgPadKontrol::Event& event)
+    {
+        std::lock_guard<std::mutex> lock(_stagedMutex);
+        if (_staged.size() == maxEventsPerBundle)
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _staged.push_back(StagedEvent{controller, event});
+    }
+
+    std::error_code flush()
+    {
+        // The bundle is built and sent outside the staging lock, senders
+        // aren't blocked by the network.
+        std::lock_guard<std::mutex> sendLock(_sendMutex);
+        {
+            std::lock_guard<std::mutex> lock(_stagedMutex);
+            if (_staged.empty())
+                return std::error_code{};
+            // Both keep their capacity.
+            std::swap(_staged, _sending);
+        }
+
+        // liblo messages can't be reused, they are only allocated here, once
+        // per bundle.
+        lo_bundle bundle = lo_bundle_new(LO_TT_IMMEDIATE);
+        for (const auto& staged : _sending)
+            addMessage(bundle, staged);
+        _sending.clear();
+
+        std::error_code error;
+        for (const auto& target : _targets)
+        {
+            if (lo_send_bundle(target.get(), bundle) == -1)
+                error = std::make_error_code(std::errc::host_unreachable);
+        }
+        lo_bundle_free_recursive(bundle);
+        return error;
+    }
+
+    size_t droppedEvents() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<AddressHandle> _targets;
+
+    std::mutex _stagedMutex;
+    std::vector<StagedEvent> _staged;
+
+    std::mutex _sendMutex;
+    std::vector<StagedEvent> _sending;
+
+    std::atomic<size_t> _dropped{0};
+};
+
+Expected<OscOutput> OscOutput::create(const std::vector<std::string>& urls)
+{
+    if (urls.empty())
+        return tl::make_unexpected(
+            std::make_error_code(std::errc::invalid_argument));
+
+    std::vector<AddressHandle> targets;
+    for (const auto& url : urls)
+    {
+        AddressHandle address{lo_address_new_from_url(url.c_str()),
+                              lo_address_free};
+        if (!address || lo_address_get_protocol(address.get()) != LO_UDP)
+        {
+            return tl::make_unexpected(
+                std::make_error_code(std::errc::invalid_argument));
+        }
+        targets.push_back(std::move(address));
+    }
+    return OscOutput{std::make_unique<_Impl>(std::move(targets))};
+}
+
+OscOutput::OscOutput(std::unique_ptr<_Impl> impl)
+    : _impl{std::move(impl)}
+{
+}
+
+OscOutput::OscOutput(OscOutput&& other) noexcept = default;
+OscOutput& OscOutput::operator=(OscOutput&& other) noexcept = default;
+
+OscOutput::~OscOutput() = default;
+
+void OscOutput::send(int controller, const midi::korgPadKontrol::Event& event)
+{
+    _impl->send(controller, event);
+}
+
+std::error_code OscOutput::flush()
+{
+    return _impl->flush();
+}
+
+size_t OscOutput::droppedEvents() const
+{
+    return _impl->droppedEvents();
+}
+
+} // namespace paddock::io
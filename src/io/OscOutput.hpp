@@ -0,0 +1,63 @@
+#pragma once
+
+#include "midi/pads/korgPadKontrol/nativeEvents.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddock::io
+{
+/// Mirrors the events of the controllers in native mode as OSC messages.
+///
+/// The events are staged in a preallocated buffer and flush sends them as a
+/// single bundle to each target, one packet per dispatch cycle instead of one
+/// per event. All the messages start with the id of the controller, which
+/// the caller keeps the same while it's connected, e.g. the MIDI client
+/// number of its device:
+///
+///     /paddock/pad ,iiii    controller, pad (0-15), velocity, on (0/1)
+///     /paddock/knob ,iii    controller, knob (0/1), value
+///     /paddock/xy ,iii      controller, x, y
+///     /paddock/wheel ,ii    controller, +1 clockwise, -1 counterclockwise
+///     /paddock/pedal ,ii    controller, value
+///     /paddock/switch ,iii  controller, switch, pressed (0/1)
+///
+/// The functions can be called from any thread.
+class OscOutput
+{
+public:
+    /// Stages at most this many events between flushes, the others are
+    /// dropped.
+    static constexpr size_t maxEventsPerBundle = 256;
+
+    /// @param urls UDP targets, e.g. osc.udp://localhost:9000/
+    static Expected<OscOutput> create(const std::vector<std::string>& urls);
+
+    OscOutput(OscOutput&& other) noexcept;
+    OscOutput& operator=(OscOutput&& other) noexcept;
+
+    OscOutput(const OscOutput& other) = delete;
+    OscOutput& operator=(const OscOutput& other) = delete;
+
+    ~OscOutput();
+
+    void send(int controller, const midi::korgPadKontrol::Event& event);
+
+    /// Sends the staged events, does nothing if there are none.
+    /// @return an error if a target couldn't be reached, the events are
+    /// discarded anyway
+    std::error_code flush();
+
+    size_t droppedEvents() const;
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+
+    OscOutput(std::unique_ptr<_Impl> impl);
+};
+
+} // namespace paddock::io
@@ -0,0 +1,202 @@
+#include "Session.hpp"
+
+#include "MappedFile.hpp"
+#include "errors.hpp"
+#include "files.hpp"
+
+#include "utils/encodings.hpp"
+
+#include <span>
+#include <system_error>
+
+namespace paddock::io
+{
+using json = nlohmann::json;
+
+namespace
+{
+/// Builds a Session from the SAX events of a session document. Unknown keys
+/// are skipped without building any value.
+class SessionReader : public nlohmann::json_sax<json>
+{
+public:
+    Expected<io::Session> result() &&
+    {
+        if (_error)
+            return tl::make_unexpected(_error);
+        if (!_hasModel)
+            return tl::make_unexpected(SerializationError::invalidDocument);
+        return std::move(_session);
+    }
+
+    bool null() override { return _skip(); }
+    bool boolean(bool) override { return _skip(); }
+
+    bool number_integer(number_integer_t value) override
+    {
+        return _number(value);
+    }
+
+    bool number_unsigned(number_unsigned_t value) override
+    {
+        return _number(static_cast<number_integer_t>(value));
+    }
+
+    bool number_float(number_float_t, const string_t&) override
+    {
+        return _skip();
+    }
+
+    bool string(string_t& value) override
+    {
+        if (!_isTopLevelValue())
+            return _skip();
+
+        if (_key != Key::program)
+            return true;
+
+        const auto bytes = fromBase64(value);
+        if (!bytes)
+            return _fail(SerializationError::invalidDocument);
+        _session.program.assign(reinterpret_cast<const char*>(bytes->data()),
+                                bytes->size());
+        return true;
+    }
+
+    bool binary(binary_t&) override { return _skip(); }
+
+    bool start_object(std::size_t) override { return _startNested(); }
+    bool end_object() override { return _endNested(); }
+    bool start_array(std::size_t) override
+    {
+        // The document must be an object.
+        if (_depth == 0)
+            return _fail(SerializationError::invalidDocument);
+        return _startNested();
+    }
+    bool end_array() override { return _endNested(); }
+
+    bool key(string_t& value) override
+    {
+        if (_depth != 1)
+            return true;
+        if (value == "model")
+            _key = Key::model;
+        else if (value == "program")
+            _key = Key::program;
+        else
+            _key = Key::other;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception&) override
+    {
+        return _fail(SerializationError::invalidDocument);
+    }
+
+private:
+    enum class Key
+    {
+        other,
+        model,
+        program
+    };
+
+    io::Session _session{};
+    bool _hasModel{false};
+    std::error_code _error;
+
+    int _depth{0};
+    Key _key{Key::other};
+
+    bool _isTopLevelValue() const { return _depth == 1; }
+
+    bool _fail(std::error_code error)
+    {
+        _error = error;
+        return false;
+    }
+
+    bool _skip()
+    {
+        if (_depth == 0)
+            return _fail(SerializationError::invalidDocument);
+        if (_isTopLevelValue() && _key != Key::other)
+            return _fail(SerializationError::invalidDocument);
+        return true;
+    }
+
+    bool _number(number_integer_t value)
+    {
+        if (!_isTopLevelValue() || _key != Key::model)
+            return _skip();
+        _session.model = static_cast<PadModel>(value);
+        _hasModel = true;
+        return true;
+    }
+
+    bool _startNested()
+    {
+        if (_isTopLevelValue() && _key != Key::other)
+            return _fail(SerializationError::invalidDocument);
+        ++_depth;
+        return true;
+    }
+
+    bool _endNested()
+    {
+        --_depth;
+        return true;
+    }
+};
+} // namespace
+
+Session Serializer<Session>::deserialize(const json& in)
+{
+    std::string program;
+    if (const auto encoded = in.find("program"); encoded != in.end())
+    {
+        const auto bytes = fromBase64(encoded->get_ref<const std::string&>());
+        if (!bytes)
+            throw std::system_error(bytes.error());
+        program.assign(reinterpret_cast<const char*>(bytes->data()),
+                       bytes->size());
+    }
+    return Session{static_cast<PadModel>(in.at("model").get<int>()),
+                   std::move(program)};
+}
+
+json Serializer<Session>::serialize(const Session& session)
+{
+    json j;
+    j["model"] = static_cast<int>(session.model);
+    j["program"] = toBase64(std::as_bytes(std::span{session.program}));
+    return j;
+}
+
+Expected<io::Session> readSession(const std::string& filePath)
+{
+    const auto file = MappedFile::open(filePath);
+    if (!file)
+        return tl::make_unexpected(file.error());
+
+    // The document is parsed straight from the mapping without building a
+    // DOM, only the decoded program is copied.
+    const auto data = file->data();
+    SessionReader reader;
+    json::sax_parse(data.data(), data.data() + data.size(), &reader);
+    return std::move(reader).result();
+}
+
+std::string toDocument(const io::Session& session)
+{
+    return Serializer<io::Session>::serialize(session).dump(4) + '\n';
+}
+
+std::error_code writeSession(const std::string& filePath, io::Session session)
+{
+    return writeFileAtomically(filePath, toDocument(session));
+}
+
+} // namespace paddock::io
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "io/Serializer.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <system_error>
+
+namespace paddock::io
+{
+/// The controller a session was made for. The values are stored in session
+/// files and match paddock::ControllerModel::Model in the application.
+enum class PadModel
+{
+    none = 0,
+    korgPadKontrol
+};
+
+struct Session
+{
+    PadModel model;
+    /// The program in the binary form returned by Program::serialize
+    std::string program;
+};
+
+template <>
+struct Serializer<Session>
+{
+    /// @throw std::exception if the document is malformed
+    static Session deserialize(const nlohmann::json& in);
+
+    static nlohmann::json serialize(const Session& session);
+};
+
+Expected<io::Session> readSession(const std::string& filePath);
+/// The file is replaced atomically, see io::writeFileAtomically
+std::error_code writeSession(const std::string& filePath, io::Session);
+
+/// The content written by writeSession
+std::string toDocument(const io::Session& session);
+
+} // namespace paddock::io
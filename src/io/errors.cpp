@@ -0,0 +1,52 @@
+#include "errors.hpp"
+
+#include "core/errors.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace paddock::io
+{
+namespace
+{
+class SerializationErrorCategory : public std::error_category
+{
+    const char* name() const noexcept override
+    {
+        return "paddock-serialization-error";
+    }
+    std::string message(int code) const override
+    {
+        using Error = SerializationError;
+        switch (static_cast<Error>(code))
+        {
+        case Error::invalidDocument:
+            return "Malformed document";
+        case Error::invalidHeader:
+            return "Unrecognized binary data header";
+        case Error::unsupportedVersion:
+            return "Unsupported binary data format version";
+        case Error::invalidSize:
+            return "Unexpected binary data size";
+        default:
+            throw std::logic_error("Unknown error code");
+        }
+    }
+    bool equivalent(int code, const std::error_condition& condition) const
+        noexcept override
+    {
+        return (condition == core::ErrorType::program);
+    }
+};
+
+const SerializationErrorCategory serializationErrorCategory{};
+
+} // namespace
+
+std::error_code make_error_code(SerializationError error)
+{
+    return std::error_code{static_cast<int>(error),
+                           serializationErrorCategory};
+}
+
+} // namespace paddock::io
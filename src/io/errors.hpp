@@ -0,0 +1,25 @@
+#pragma once
+
+#include <system_error>
+
+namespace paddock::io
+{
+enum class SerializationError
+{
+    invalidDocument = 1,
+    invalidHeader,
+    unsupportedVersion,
+    invalidSize
+};
+
+std::error_code make_error_code(SerializationError error);
+
+} // namespace paddock::io
+
+namespace std
+{
+template <>
+struct is_error_code_enum<paddock::io::SerializationError> : true_type
+{
+};
+} // namespace std
@@ -0,0 +1,94 @@
+#include "files.hpp"
+
+#include "core/errors.hpp"
+
+#ifdef Linux
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#endif
+
+#include <cerrno>
+
+namespace paddock::io
+{
+namespace
+{
+#ifdef Linux
+/// Makes a rename in the directory durable.
+void syncDirectory(const std::string& filePath)
+{
+    auto directory = std::filesystem::path{filePath}.parent_path();
+    if (directory.empty())
+        directory = ".";
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd == -1)
+        return;
+    ::fsync(fd);
+    ::close(fd);
+}
+#endif
+} // namespace
+
+std::error_code lastError()
+{
+    return std::make_error_code(static_cast<std::errc>(errno));
+}
+
+std::error_code writeAll(int fd, std::span<const std::byte> data)
+{
+#ifdef Linux
+    while (!data.empty())
+    {
+        const auto written = ::write(fd, data.data(), data.size());
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return lastError();
+        }
+        data = data.subspan(static_cast<size_t>(written));
+    }
+    return std::error_code{};
+#else
+    (void)fd;
+    (void)data;
+    return core::Error::unimplemented;
+#endif
+}
+
+std::error_code writeFileAtomically(const std::string& filePath,
+                                    std::string_view content)
+{
+#ifdef Linux
+    const auto tmpPath = filePath + ".tmp";
+    const int fd =
+        ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return lastError();
+
+    auto error = writeAll(fd, std::as_bytes(std::span{content}));
+    if (!error && ::fdatasync(fd) == -1)
+        error = lastError();
+    if (::close(fd) == -1 && !error)
+        error = lastError();
+    if (!error && ::rename(tmpPath.c_str(), filePath.c_str()) == -1)
+        error = lastError();
+
+    if (error)
+    {
+        ::unlink(tmpPath.c_str());
+        return error;
+    }
+
+    syncDirectory(filePath);
+    return std::error_code{};
+#else
+    (void)filePath;
+    (void)content;
+    return core::Error::unimplemented;
+#endif
+}
+
+} // namespace paddock::io
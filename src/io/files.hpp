@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace paddock::io
+{
+/// The error of the last failed system call, taken from errno.
+std::error_code lastError();
+
+/// Writes all the data to a file descriptor, retrying the short and
+/// interrupted writes.
+std::error_code writeAll(int fd, std::span<const std::byte> data);
+
+/// Replaces the content of a file so that readers and crashes only ever see
+/// the old or the new content. The content is written to a temporary file in
+/// the same directory, synced to disk and renamed over the target.
+std::error_code writeFileAtomically(const std::string& filePath,
+                                    std::string_view content);
+
+} // namespace paddock::io
@@ -0,0 +1,143 @@
+#include "Program.hpp"
+#include "Scene.hpp"
+
+#include "io/errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace paddock::io::korgPadKontrol
+{
+namespace
+{
+using midi::Mapping;
+
+constexpr std::array<char, 4> mappingMagic{'P', 'K', 'M', 'P'};
+constexpr size_t mappingHeaderSize = mappingMagic.size() + 1 + 2;
+constexpr size_t ruleSize = 10;
+constexpr size_t maxRuleCount = 0xFFFF;
+/// Stands for the optional values that are not set.
+constexpr unsigned char unset = 0xFF;
+
+void appendOptional(std::string& out,
+                    const std::optional<midi::Value7bit>& value)
+{
+    out.push_back(static_cast<char>(value ? *value : unset));
+}
+
+std::optional<midi::Value7bit> readOptional(unsigned char byte)
+{
+    if (byte == unset)
+        return std::nullopt;
+    return midi::Value7bit(byte);
+}
+
+void appendRule(std::string& out, const Mapping::Rule& rule)
+{
+    out.push_back(static_cast<char>(rule.kind));
+    appendOptional(out, rule.channel);
+    out.push_back(static_cast<char>(rule.low));
+    out.push_back(static_cast<char>(rule.high));
+    out.push_back(static_cast<char>(rule.mute));
+    appendOptional(out, rule.outputChannel);
+    appendOptional(out, rule.outputNumber);
+    out.push_back(static_cast<char>(static_cast<signed char>(rule.transpose)));
+    out.push_back(static_cast<char>(rule.valueScale >> 8));
+    out.push_back(static_cast<char>(rule.valueScale & 0xFF));
+}
+
+Mapping::Rule readRule(std::string_view bytes)
+{
+    const auto byte = [bytes](size_t i) {
+        return static_cast<unsigned char>(bytes[i]);
+    };
+    Mapping::Rule rule;
+    rule.kind = Mapping::Kind(byte(0));
+    rule.channel = readOptional(byte(1));
+    rule.low = byte(2);
+    rule.high = byte(3);
+    rule.mute = byte(4) != 0;
+    rule.outputChannel = readOptional(byte(5));
+    rule.outputNumber = readOptional(byte(6));
+    rule.transpose = static_cast<signed char>(byte(7));
+    rule.valueScale = byte(8) << 8 | byte(9);
+    return rule;
+}
+} // namespace
+
+Expected<std::string> serializeProgram(
+    const midi::korgPadKontrol::Program& program)
+{
+    // The rules are validated when the mapping is compiled.
+    const auto& rules = program.mapping().rules();
+    const auto* scene = program.scene();
+    if (!scene || rules.size() > maxRuleCount)
+    {
+        return tl::make_unexpected(
+            std::make_error_code(std::errc::invalid_argument));
+    }
+
+    auto bytes = serializeScene(*scene);
+    if (!bytes)
+        return bytes;
+
+    if (rules.empty())
+        return bytes;
+
+    bytes->append(mappingMagic.begin(), mappingMagic.end());
+    bytes->push_back(static_cast<char>(mappingFormatVersion));
+    bytes->push_back(static_cast<char>(rules.size() >> 8));
+    bytes->push_back(static_cast<char>(rules.size() & 0xFF));
+    for (const auto& rule : rules)
+        appendRule(*bytes, rule);
+    return bytes;
+}
+
+Expected<midi::korgPadKontrol::Program> deserializeProgram(
+    std::string_view bytes)
+{
+    auto scene = deserializeScene(bytes.substr(0, sceneBinarySize));
+    if (!scene)
+        return tl::make_unexpected(scene.error());
+
+    midi::korgPadKontrol::Program program;
+    program.setScene(std::move(*scene));
+
+    const auto mapping = bytes.substr(sceneBinarySize);
+    if (mapping.empty())
+        return program;
+
+    if (mapping.size() < mappingHeaderSize ||
+        !std::equal(mappingMagic.begin(), mappingMagic.end(), mapping.begin()))
+    {
+        return tl::make_unexpected(SerializationError::invalidHeader);
+    }
+
+    const auto byte = [mapping](size_t i) {
+        return static_cast<unsigned char>(mapping[i]);
+    };
+    if (byte(mappingMagic.size()) != mappingFormatVersion)
+        return tl::make_unexpected(SerializationError::unsupportedVersion);
+
+    const size_t count =
+        byte(mappingMagic.size() + 1) << 8 | byte(mappingMagic.size() + 2);
+    if (mapping.size() != mappingHeaderSize + count * ruleSize)
+        return tl::make_unexpected(SerializationError::invalidSize);
+
+    std::vector<Mapping::Rule> rules;
+    rules.reserve(count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        rules.push_back(
+            readRule(mapping.substr(mappingHeaderSize + i * ruleSize)));
+    }
+    auto compiled = Mapping::compile(std::move(rules));
+    if (!compiled)
+        return tl::make_unexpected(compiled.error());
+    program.setMapping(std::move(*compiled));
+    return program;
+}
+
+} // namespace paddock::io::korgPadKontrol
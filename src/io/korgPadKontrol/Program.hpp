@@ -0,0 +1,26 @@
+#pragma once
+
+#include "midi/pads/korgPadKontrol/Program.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace paddock::io::korgPadKontrol
+{
+/// Binary format version of the mapping section.
+constexpr unsigned char mappingFormatVersion = 1;
+
+/// The binary form of a program is the binary form of its scene, followed
+/// by the mapping rules if there are any: a 4 byte magic, the format version,
+/// the number of rules and the rules. Programs without rules are the same as
+/// their scenes, which are valid programs without rules.
+/// @return std::errc::invalid_argument if the program has no scene, the
+/// scene is not valid or there are more than 65535 rules
+Expected<std::string> serializeProgram(
+    const midi::korgPadKontrol::Program& program);
+Expected<midi::korgPadKontrol::Program> deserializeProgram(
+    std::string_view bytes);
+
+} // namespace paddock::io::korgPadKontrol
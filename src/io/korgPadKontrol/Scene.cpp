@@ -0,0 +1,293 @@
+#include "Scene.hpp"
+
+#include "io/errors.hpp"
+
+#include "utils/overloaded.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace paddock::io
+{
+using json = nlohmann::json;
+using midi::korgPadKontrol::Scene;
+
+namespace
+{
+constexpr std::array<char, 4> sceneMagic{'P', 'K', 'S', 'C'};
+
+template <typename Enum, size_t size>
+using EnumNames = std::array<std::pair<Enum, const char*>, size>;
+
+constexpr EnumNames<Scene::Port, 2> portNames{
+    {{Scene::Port::A, "A"}, {Scene::Port::B, "B"}}};
+
+constexpr EnumNames<Scene::SwitchType, 2> switchTypeNames{
+    {{Scene::SwitchType::Momentary, "momentary"},
+     {Scene::SwitchType::Toggle, "toggle"}}};
+
+constexpr EnumNames<Scene::KnobType, 3> knobTypeNames{
+    {{Scene::KnobType::PitchBend, "pitchBend"},
+     {Scene::KnobType::AfterTouch, "afterTouch"},
+     {Scene::KnobType::Controller, "controller"}}};
+
+using Curve = Scene::Note::VelocityCurve;
+constexpr EnumNames<Curve, 8> curveNames{{{Curve::curve1, "curve1"},
+                                          {Curve::curve2, "curve2"},
+                                          {Curve::curve3, "curve3"},
+                                          {Curve::curve4, "curve4"},
+                                          {Curve::curve5, "curve5"},
+                                          {Curve::curve6, "curve6"},
+                                          {Curve::curve7, "curve7"},
+                                          {Curve::curve8, "curve8"}}};
+
+template <typename Enum, size_t size>
+const char* toString(Enum value, const EnumNames<Enum, size>& names)
+{
+    for (const auto& [enumValue, name] : names)
+    {
+        if (enumValue == value)
+            return name;
+    }
+    throw std::invalid_argument("Invalid enum value");
+}
+
+template <typename Enum, size_t size>
+Enum fromString(const json& in, const EnumNames<Enum, size>& names)
+{
+    const auto& string = in.get_ref<const std::string&>();
+    for (const auto& [value, name] : names)
+    {
+        if (string == name)
+            return value;
+    }
+    throw std::invalid_argument("Invalid enum name: " + string);
+}
+
+json serializeTrigger(const Scene::Trigger& trigger)
+{
+    json out;
+    out["enabled"] = trigger.enabled;
+    out["midiChannel"] = trigger.midiChannel;
+    out["switchType"] = toString(trigger.type, switchTypeNames);
+    out["port"] = toString(trigger.port, portNames);
+    out["flamRoll"] = trigger.hasFlamRoll;
+    std::visit(
+        overloaded{[&out](const Scene::Note& note) {
+                       json action;
+                       action["note"] = note.note;
+                       std::visit(overloaded{[&action](Curve curve) {
+                                                 action["velocity"] =
+                                                     toString(curve,
+                                                              curveNames);
+                                             },
+                                             [&action](midi::Value7bit value) {
+                                                 action["velocity"] = value;
+                                             }},
+                                  note.velocity);
+                       out["note"] = std::move(action);
+                   },
+                   [&out](const Scene::Control& control) {
+                       json action;
+                       action["parameter"] = control.param;
+                       action["value"] = control.value;
+                       action["releaseValue"] = control.releaseValue;
+                       out["control"] = std::move(action);
+                   }},
+        trigger.action);
+    return out;
+}
+
+Scene::Trigger deserializeTrigger(const json& in)
+{
+    Scene::Trigger trigger;
+    trigger.enabled = in.at("enabled").get<bool>();
+    trigger.midiChannel = in.at("midiChannel").get<int>();
+    trigger.type = fromString(in.at("switchType"), switchTypeNames);
+    trigger.port = fromString(in.at("port"), portNames);
+    trigger.hasFlamRoll = in.at("flamRoll").get<bool>();
+    if (const auto note = in.find("note"); note != in.end())
+    {
+        Scene::Note action;
+        action.note = note->at("note").get<midi::Value7bit>();
+        const auto& velocity = note->at("velocity");
+        if (velocity.is_string())
+            action.velocity = fromString(velocity, curveNames);
+        else
+            action.velocity = velocity.get<midi::Value7bit>();
+        trigger.action = action;
+    }
+    else
+    {
+        const auto& control = in.at("control");
+        trigger.action = Scene::Control{
+            control.at("parameter").get<midi::Value7bit>(),
+            control.at("value").get<midi::Value7bit>(),
+            control.at("releaseValue").get<midi::Value7bit>()};
+    }
+    return trigger;
+}
+
+json serializeKnob(const Scene::Knob& knob)
+{
+    json out;
+    out["enabled"] = knob.enabled;
+    out["type"] = toString(knob.type, knobTypeNames);
+    out["parameter"] = knob.param;
+    out["reversePolarity"] = knob.reversePolarity;
+    auto pads = json::array();
+    for (int i = 0; i != 16; ++i)
+    {
+        if (knob.padAssignmentBits & (1 << i))
+            pads.push_back(i);
+    }
+    out["pads"] = std::move(pads);
+    out["pedal"] = knob.pedalAssigned;
+    return out;
+}
+
+void deserializeKnob(const json& in, Scene::Knob& knob)
+{
+    knob.enabled = in.at("enabled").get<bool>();
+    knob.type = fromString(in.at("type"), knobTypeNames);
+    knob.param = in.at("parameter").get<midi::Value7bit>();
+    knob.reversePolarity = in.at("reversePolarity").get<bool>();
+    knob.padAssignmentBits = 0;
+    for (const auto& pad : in.at("pads"))
+    {
+        const auto index = pad.get<int>();
+        if (index < 0 || index >= 16)
+            throw std::out_of_range("Invalid pad index");
+        knob.padAssignmentBits |= 1 << index;
+    }
+    knob.pedalAssigned = in.at("pedal").get<bool>();
+}
+
+json serializeAxis(const Scene::Axis& axis)
+{
+    auto out = serializeKnob(axis);
+    out["releaseValue"] = int(axis.releaseValue);
+    return out;
+}
+
+Scene::Axis deserializeAxis(const json& in)
+{
+    Scene::Axis axis;
+    deserializeKnob(in, axis);
+    axis.releaseValue = static_cast<char>(in.at("releaseValue").get<int>());
+    return axis;
+}
+
+json serializeRepeater(const Scene::Repeater& repeater)
+{
+    json out;
+    out["minSpeed"] = repeater.minSpeed;
+    out["maxSpeed"] = repeater.maxSpeed;
+    out["minVolume"] = repeater.minVolume;
+    out["maxVolume"] = repeater.maxVolume;
+    return out;
+}
+
+Scene::Repeater deserializeRepeater(const json& in)
+{
+    return Scene::Repeater{in.at("minSpeed").get<unsigned char>(),
+                           in.at("maxSpeed").get<unsigned char>(),
+                           in.at("minVolume").get<midi::Value7bit>(),
+                           in.at("maxVolume").get<midi::Value7bit>()};
+}
+
+} // namespace
+
+namespace korgPadKontrol
+{
+Expected<std::string> serializeScene(const Scene& scene)
+{
+    const auto payload = midi::korgPadKontrol::encodeScene(scene);
+    if (!payload)
+        return tl::make_unexpected(payload.error());
+
+    std::string bytes;
+    bytes.reserve(sceneBinarySize);
+    bytes.append(sceneMagic.begin(), sceneMagic.end());
+    bytes.push_back(static_cast<char>(sceneFormatVersion));
+    std::transform(payload->begin(), payload->end(), std::back_inserter(bytes),
+                   [](std::byte byte) { return static_cast<char>(byte); });
+    return bytes;
+}
+
+Expected<Scene> deserializeScene(std::string_view bytes)
+{
+    if (bytes.size() < sceneMagic.size() + 1 ||
+        !std::equal(sceneMagic.begin(), sceneMagic.end(), bytes.begin()))
+    {
+        return tl::make_unexpected(SerializationError::invalidHeader);
+    }
+
+    const auto version = static_cast<unsigned char>(bytes[sceneMagic.size()]);
+    if (version != sceneFormatVersion)
+        return tl::make_unexpected(SerializationError::unsupportedVersion);
+
+    if (bytes.size() != sceneBinarySize)
+        return tl::make_unexpected(SerializationError::invalidSize);
+
+    const auto payload =
+        std::as_bytes(std::span{bytes}.subspan(sceneMagic.size() + 1));
+    return midi::korgPadKontrol::decodeScene(payload).and_then(
+        [](Scene scene) -> Expected<Scene> {
+            if (auto error = midi::korgPadKontrol::validateScene(scene))
+                return tl::make_unexpected(error);
+            return scene;
+        });
+}
+
+} // namespace korgPadKontrol
+
+Scene Serializer<Scene>::deserialize(const json& in)
+{
+    Scene scene;
+    const auto& pads = in.at("pads");
+    if (pads.size() != scene.pads.size())
+        throw std::out_of_range("Invalid number of pads");
+    for (size_t i = 0; i != scene.pads.size(); ++i)
+        scene.pads[i] = deserializeTrigger(pads[i]);
+    scene.pedal = deserializeTrigger(in.at("pedal"));
+
+    const auto& knobs = in.at("knobs");
+    if (knobs.size() != scene.knobs.size())
+        throw std::out_of_range("Invalid number of knobs");
+    for (size_t i = 0; i != scene.knobs.size(); ++i)
+        deserializeKnob(knobs[i], scene.knobs[i]);
+    scene.x = deserializeAxis(in.at("x"));
+    scene.y = deserializeAxis(in.at("y"));
+
+    scene.flam = deserializeRepeater(in.at("flam"));
+    scene.roll = deserializeRepeater(in.at("roll"));
+    scene.fixedVelocity = in.at("fixedVelocity").get<midi::Value7bit>();
+    return scene;
+}
+
+json Serializer<Scene>::serialize(const Scene& scene)
+{
+    json out;
+    auto pads = json::array();
+    for (const auto& pad : scene.pads)
+        pads.push_back(serializeTrigger(pad));
+    out["pads"] = std::move(pads);
+    out["pedal"] = serializeTrigger(scene.pedal);
+
+    auto knobs = json::array();
+    for (const auto& knob : scene.knobs)
+        knobs.push_back(serializeKnob(knob));
+    out["knobs"] = std::move(knobs);
+    out["x"] = serializeAxis(scene.x);
+    out["y"] = serializeAxis(scene.y);
+
+    out["flam"] = serializeRepeater(scene.flam);
+    out["roll"] = serializeRepeater(scene.roll);
+    out["fixedVelocity"] = scene.fixedVelocity;
+    return out;
+}
+
+} // namespace paddock::io
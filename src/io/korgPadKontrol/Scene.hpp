@@ -0,0 +1,44 @@
+#pragma once
+
+#include "io/Serializer.hpp"
+
+#include "midi/pads/korgPadKontrol/Scene.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace paddock::io
+{
+namespace korgPadKontrol
+{
+using Scene = midi::korgPadKontrol::Scene;
+
+/// Binary format version written by serializeScene.
+constexpr unsigned char sceneFormatVersion = 1;
+
+/// The binary form is a 4 byte magic, the format version and the 138 byte
+/// scene dump in the device encoding.
+constexpr size_t sceneBinarySize = 4 + 1 + 138;
+
+/// @return std::errc::invalid_argument if the scene is not valid
+Expected<std::string> serializeScene(const Scene& scene);
+Expected<Scene> deserializeScene(std::string_view bytes);
+
+} // namespace korgPadKontrol
+
+/// Human readable form of a scene.
+template <>
+struct Serializer<midi::korgPadKontrol::Scene>
+{
+    /// @throw std::exception if the document is malformed. Value ranges are
+    /// not checked, use midi::korgPadKontrol::validateScene for that.
+    static midi::korgPadKontrol::Scene deserialize(const nlohmann::json& in);
+
+    static nlohmann::json serialize(const midi::korgPadKontrol::Scene& scene);
+};
+
+} // namespace paddock::io
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "io/Capture.hpp"
+#include "io/tests/temporaryPath.hpp"
+
+#include "utils/byte.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace paddock
+{
+namespace
+{
+class Capture : public ::testing::Test
+{
+protected:
+    std::string path = tests::temporaryPath("capture", ".capture");
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    void writeCapture()
+    {
+        auto writer = io::CaptureWriter::create(path);
+        ASSERT_TRUE(writer);
+        writer->recordDeviceInput(std::vector{0x42_b, 0x40_b, 0x6E_b});
+        writer->recordClientInput(midi::events::NoteOn{9, 36, 100}, 24);
+        writer->recordClientInput(
+            midi::events::SysEx{{0xF0_b, 0x7E_b, 0x01_b, 0xF7_b}});
+        writer->recordDeviceInput(std::vector<std::byte>{});
+    }
+};
+} // namespace
+
+TEST_F(Capture, read_records)
+{
+    writeCapture();
+
+    auto reader = io::CaptureReader::open(path);
+    ASSERT_TRUE(reader);
+
+    auto record = reader->next();
+    ASSERT_TRUE(record);
+    auto payload = std::get<std::span<const std::byte>>(record->data);
+    EXPECT_EQ(std::vector(payload.begin(), payload.end()),
+              std::vector({0x42_b, 0x40_b, 0x6E_b}));
+    EXPECT_EQ(record->source, 0);
+    auto time = record->time;
+
+    record = reader->next();
+    ASSERT_TRUE(record);
+    EXPECT_GE(record->time, time);
+    EXPECT_EQ(record->source, 24);
+    const auto& noteOn = std::get<midi::events::NoteOn>(
+        std::get<midi::events::Event>(record->data));
+    EXPECT_EQ(noteOn.channel, 9);
+    EXPECT_EQ(noteOn.note, 36);
+    EXPECT_EQ(noteOn.velocity, 100);
+
+    record = reader->next();
+    ASSERT_TRUE(record);
+    const auto& sysEx = std::get<midi::events::SysEx>(
+        std::get<midi::events::Event>(record->data));
+    EXPECT_EQ(sysEx.data, std::vector({0xF0_b, 0x7E_b, 0x01_b, 0xF7_b}));
+
+    record = reader->next();
+    ASSERT_TRUE(record);
+    EXPECT_TRUE(std::get<std::span<const std::byte>>(record->data).empty());
+
+    EXPECT_FALSE(reader->next());
+
+    reader->rewind();
+    EXPECT_TRUE(reader->next());
+}
+
+TEST_F(Capture, torn_record)
+{
+    writeCapture();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    auto reader = io::CaptureReader::open(path);
+    ASSERT_TRUE(reader);
+    size_t count = 0;
+    while (reader->next())
+        ++count;
+    // The last record has no payload, the cut tears its 16 byte header and
+    // the reader stops before it.
+    EXPECT_EQ(count, 3);
+}
+
+TEST_F(Capture, not_a_capture)
+{
+    std::ofstream{path} << "{}";
+    auto reader = io::CaptureReader::open(path);
+    ASSERT_FALSE(reader);
+    EXPECT_EQ(reader.error(), std::errc::invalid_argument);
+}
+
+TEST_F(Capture, replay)
+{
+    writeCapture();
+    auto reader = io::CaptureReader::open(path);
+    ASSERT_TRUE(reader);
+
+    std::vector<size_t> indices;
+    auto error = io::replayCapture(
+        *reader,
+        [&indices](const io::CaptureRecord& record) {
+            indices.push_back(record.data.index());
+            return std::error_code{};
+        },
+        0);
+    EXPECT_FALSE(error);
+    EXPECT_EQ(indices, std::vector<size_t>({0, 1, 1, 0}));
+
+    // Errors stop the replay.
+    reader->rewind();
+    size_t count = 0;
+    error = io::replayCapture(
+        *reader,
+        [&count](const io::CaptureRecord&) {
+            ++count;
+            return std::make_error_code(std::errc::io_error);
+        },
+        0);
+    EXPECT_EQ(error, std::errc::io_error);
+    EXPECT_EQ(count, 1);
+}
+
+} // namespace paddock
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "io/DeviceStates.hpp"
+#include "io/errors.hpp"
+#include "io/tests/temporaryPath.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace paddock
+{
+namespace
+{
+const std::vector<std::byte> identity{std::byte{0x7E}, std::byte{0x00},
+                                      std::byte{0x06}, std::byte{0x02},
+                                      std::byte{0x42}, std::byte{0x6E}};
+} // namespace
+
+TEST(DeviceStates, missing_file)
+{
+    auto states = io::DeviceStates::read("/non/existent/file.devices");
+    ASSERT_TRUE(states);
+    ASSERT_TRUE(states->empty());
+}
+
+TEST(DeviceStates, round_trip)
+{
+    const auto path = tests::temporaryPath("device_states");
+
+    io::DeviceStates states;
+    ASSERT_EQ(states.scene(identity), nullptr);
+    states.setScene(identity, std::string("PKSC\x01\x00\xFF", 7));
+    ASSERT_FALSE(states.write(path));
+
+    auto read = io::DeviceStates::read(path);
+    std::remove(path.c_str());
+    ASSERT_TRUE(read);
+
+    const auto* scene = read->scene(identity);
+    ASSERT_NE(scene, nullptr);
+    ASSERT_EQ(*scene, std::string("PKSC\x01\x00\xFF", 7));
+
+    auto other = identity;
+    other.back() = std::byte{0x00};
+    ASSERT_EQ(read->scene(other), nullptr);
+}
+
+TEST(DeviceStates, invalid_document)
+{
+    const auto path = tests::temporaryPath("device_states");
+    {
+        std::ofstream out(path);
+        out << R"({"devices": [{"identity": "not base64!", "scene": ""}]})";
+    }
+    auto states = io::DeviceStates::read(path);
+    std::remove(path.c_str());
+    ASSERT_FALSE(states);
+    ASSERT_EQ(states.error(), io::SerializationError::invalidDocument);
+}
+
+} // namespace paddock
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "io/Journal.hpp"
+#include "io/MappedFile.hpp"
+#include "io/tests/temporaryPath.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace paddock
+{
+namespace
+{
+class Journal : public ::testing::Test
+{
+protected:
+    std::string sessionPath = tests::temporaryPath("journal", ".json");
+    std::string journalPath = sessionPath + ".journal";
+
+    void TearDown() override
+    {
+        std::filesystem::remove(sessionPath);
+        std::filesystem::remove(journalPath);
+    }
+
+    std::string readFile(const std::string& path)
+    {
+        auto file = io::MappedFile::open(path);
+        if (!file)
+            return std::string{};
+        return std::string(file->data().begin(), file->data().end());
+    }
+};
+} // namespace
+
+TEST_F(Journal, replay)
+{
+    {
+        auto journal = io::Journal::open(sessionPath);
+        ASSERT_TRUE(journal);
+        ASSERT_TRUE(journal->pendingRecords().empty());
+        journal->append("first");
+        journal->append(std::string("sec\0nd", 6));
+        ASSERT_EQ(journal->recordCount(), 2);
+    }
+
+    auto journal = io::Journal::open(sessionPath);
+    ASSERT_TRUE(journal);
+    ASSERT_EQ(journal->pendingRecords(),
+              std::vector<std::string>({"first", std::string("sec\0nd", 6)}));
+}
+
+TEST_F(Journal, compact)
+{
+    {
+        auto journal = io::Journal::open(sessionPath);
+        journal->append("first");
+        ASSERT_FALSE(journal->compact("document").get());
+        ASSERT_EQ(journal->recordCount(), 0);
+        ASSERT_EQ(readFile(sessionPath), "document");
+        journal->append("second");
+    }
+
+    auto journal = io::Journal::open(sessionPath);
+    ASSERT_EQ(journal->pendingRecords(), std::vector<std::string>{"second"});
+    ASSERT_FALSE(std::filesystem::exists(sessionPath + ".tmp"));
+}
+
+TEST_F(Journal, torn_record)
+{
+    {
+        auto journal = io::Journal::open(sessionPath);
+        journal->append("first");
+        ASSERT_FALSE(journal->append("second").get());
+    }
+    // Simulate a crash in the middle of the last write.
+    std::filesystem::resize_file(journalPath,
+                                 std::filesystem::file_size(journalPath) - 3);
+
+    {
+        auto journal = io::Journal::open(sessionPath);
+        ASSERT_EQ(journal->pendingRecords(),
+                  std::vector<std::string>{"first"});
+        journal->append("third");
+    }
+
+    auto journal = io::Journal::open(sessionPath);
+    ASSERT_EQ(journal->pendingRecords(),
+              std::vector<std::string>({"first", "third"}));
+}
+
+TEST_F(Journal, corrupted_record)
+{
+    {
+        auto journal = io::Journal::open(sessionPath);
+        journal->append("first");
+        journal->append("second");
+    }
+    {
+        std::fstream file(journalPath,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+
+    auto journal = io::Journal::open(sessionPath);
+    ASSERT_EQ(journal->pendingRecords(), std::vector<std::string>{"first"});
+}
+
+} // namespace paddock
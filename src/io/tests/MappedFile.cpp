@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "io/MappedFile.hpp"
+#include "io/tests/temporaryPath.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace paddock
+{
+namespace
+{
+struct TemporaryFile
+{
+    std::string path;
+
+    explicit TemporaryFile(const std::string& content)
+        : path{tests::temporaryPath("mapped_file")}
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+
+    ~TemporaryFile() { std::remove(path.c_str()); }
+};
+} // namespace
+
+TEST(MappedFile, content)
+{
+    const std::string content = "{\"model\": 1}";
+    TemporaryFile file{content};
+
+    auto mapped = io::MappedFile::open(file.path);
+    ASSERT_TRUE(mapped);
+    ASSERT_EQ(std::string(mapped->data().begin(), mapped->data().end()),
+              content);
+
+    auto moved = std::move(*mapped);
+    ASSERT_TRUE(mapped->data().empty());
+    ASSERT_EQ(moved.data().size(), content.size());
+}
+
+TEST(MappedFile, empty_file)
+{
+    TemporaryFile file{""};
+    auto mapped = io::MappedFile::open(file.path);
+    ASSERT_TRUE(mapped);
+    ASSERT_TRUE(mapped->data().empty());
+}
+
+TEST(MappedFile, missing_file)
+{
+    auto mapped = io::MappedFile::open("/non/existent/file");
+    ASSERT_FALSE(mapped);
+    ASSERT_EQ(mapped.error(),
+              std::make_error_code(std::errc::no_such_file_or_directory));
+}
+
+} // namespace paddock
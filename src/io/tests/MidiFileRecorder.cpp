@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include "io/MappedFile.hpp"
+#include "io/MidiFileRecorder.hpp"
+#include "io/tests/temporaryPath.hpp"
+
+#include <filesystem>
+#include <thread>
+
+namespace paddock
+{
+namespace
+{
+class MidiFileRecorder : public ::testing::Test
+{
+protected:
+    std::string path = tests::temporaryPath("recorder", ".mid");
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    std::vector<uint8_t> readFile()
+    {
+        auto file = io::MappedFile::open(path);
+        if (!file)
+            return {};
+        return std::vector<uint8_t>(file->data().begin(), file->data().end());
+    }
+
+    static uint32_t readNumber(const std::vector<uint8_t>& data,
+                               size_t offset, size_t size)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i != size; ++i)
+            value = value << 8 | data[offset + i];
+        return value;
+    }
+
+    /// @return the offset of the first byte past the chunk
+    static size_t checkChunk(const std::vector<uint8_t>& data, size_t offset,
+                             const std::string& type)
+    {
+        EXPECT_GE(data.size(), offset + 8);
+        EXPECT_EQ(std::string(data.begin() + offset,
+                              data.begin() + offset + 4),
+                  type);
+        return offset + 8 + readNumber(data, offset + 4, 4);
+    }
+};
+} // namespace
+
+TEST_F(MidiFileRecorder, single_track)
+{
+    auto options = io::MidiFileRecorder::defaultOptions();
+    // Half a second per tick, the events are recorded in the first one.
+    options.ticksPerQuarterNote = 1;
+    {
+        auto recorder = io::MidiFileRecorder::create(path, options);
+        ASSERT_TRUE(recorder);
+        recorder->record(midi::events::NoteOn{9, 36, 100});
+        recorder->record(midi::events::Start{});
+        recorder->record(midi::events::PitchBend{0, 0});
+        recorder->record(midi::events::ProgramChange{1, 5});
+        EXPECT_FALSE(recorder->close());
+        EXPECT_EQ(recorder->droppedEvents(), 0);
+    }
+
+    const auto data = readFile();
+    const auto trackOffset = checkChunk(data, 0, "MThd");
+    EXPECT_EQ(readNumber(data, 8, 2), 0);  // Format
+    EXPECT_EQ(readNumber(data, 10, 2), 1); // Tracks
+    EXPECT_EQ(readNumber(data, 12, 2), 1);
+    ASSERT_EQ(checkChunk(data, trackOffset, "MTrk"), data.size());
+
+    // Tempo and time signature
+    auto offset = trackOffset + 8;
+    EXPECT_EQ(std::vector(data.begin() + offset, data.begin() + offset + 15),
+              std::vector<uint8_t>({0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+                                    0x00, 0xFF, 0x58, 0x04, 0x04, 0x02, 0x18,
+                                    0x08}));
+    offset += 15;
+
+    EXPECT_EQ(std::vector(data.begin() + offset, data.end()),
+              std::vector<uint8_t>({0x00, 0x99, 36, 100,   // Note on
+                                    0x00, 0xE0, 0x00, 0x40, // Pitch bend
+                                    0x00, 0xC1, 5,          // Program change
+                                    0x00, 0xFF, 0x2F, 0x00}));
+}
+
+TEST_F(MidiFileRecorder, multi_track)
+{
+    auto options = io::MidiFileRecorder::defaultOptions();
+    options.format = io::MidiFileRecorder::Format::multiTrack;
+    {
+        auto recorder = io::MidiFileRecorder::create(path, options);
+        ASSERT_TRUE(recorder);
+        recorder->record(midi::events::Controller{0, 127, 64});
+        // Closed by the destructor
+    }
+
+    const auto data = readFile();
+    auto offset = checkChunk(data, 0, "MThd");
+    EXPECT_EQ(readNumber(data, 8, 2), 1);
+    EXPECT_EQ(readNumber(data, 10, 2), 2);
+    offset = checkChunk(data, offset, "MTrk");
+    const auto eventsOffset = offset + 8;
+    ASSERT_EQ(checkChunk(data, offset, "MTrk"), data.size());
+    EXPECT_EQ(std::vector(data.begin() + eventsOffset, data.end()),
+              std::vector<uint8_t>({0x00, 0xB0, 64, 127, //
+                                    0x00, 0xFF, 0x2F, 0x00}));
+}
+
+TEST_F(MidiFileRecorder, delta_times)
+{
+    auto options = io::MidiFileRecorder::defaultOptions();
+    // 1 tick per ms
+    options.tempo.microsecsPerQuaterNote = 960000;
+    {
+        auto recorder = io::MidiFileRecorder::create(path, options);
+        ASSERT_TRUE(recorder);
+        recorder->record(midi::events::NoteOn{0, 60, 100});
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        recorder->record(midi::events::NoteOff{0, 60, 0});
+    }
+
+    const auto data = readFile();
+    const auto offset = data.size() - 4 - 3 - 2;
+    // A two byte delta time of at least 200 ticks
+    ASSERT_EQ(data[offset] & 0x80, 0x80);
+    const auto delta = (data[offset] & 0x7F) << 7 | data[offset + 1];
+    EXPECT_GE(delta, 200);
+    EXPECT_LT(delta, 1000);
+    EXPECT_EQ(data[offset + 2], 0x80);
+}
+
+TEST_F(MidiFileRecorder, inputs)
+{
+    auto options = io::MidiFileRecorder::defaultOptions();
+    options.ticksPerQuarterNote = 1;
+    {
+        auto recorder = io::MidiFileRecorder::create(path, options);
+        ASSERT_TRUE(recorder);
+        std::thread first{[input = recorder->addInput()]() mutable {
+            input.record(midi::events::NoteOn{0, 36, 100});
+        }};
+        first.join();
+        std::thread second{[input = recorder->addInput()]() mutable {
+            input.record(midi::events::NoteOn{1, 38, 100});
+        }};
+        second.join();
+        // The writer releases the inputs, their events are written anyway.
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        EXPECT_FALSE(recorder->close());
+        EXPECT_EQ(recorder->droppedEvents(), 0);
+    }
+
+    const auto data = readFile();
+    ASSERT_GE(data.size(), 12);
+    EXPECT_EQ(std::vector(data.end() - 12, data.end()),
+              std::vector<uint8_t>({0x00, 0x90, 36, 100, //
+                                    0x00, 0x91, 38, 100, //
+                                    0x00, 0xFF, 0x2F, 0x00}));
+}
+
+TEST_F(MidiFileRecorder, invalid_options)
+{
+    auto options = io::MidiFileRecorder::defaultOptions();
+    options.ticksPerQuarterNote = 0;
+    EXPECT_FALSE(io::MidiFileRecorder::create(path, options));
+}
+
+} // namespace paddock
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include "io/OscOutput.hpp"
+
+#include <lo/lo.h>
+
+#include <string>
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi::korgPadKontrol;
+
+class OscOutput : public ::testing::Test
+{
+protected:
+    struct Message
+    {
+        std::string path;
+        std::vector<int> arguments;
+    };
+
+    lo_server server = nullptr;
+    int bundles = 0;
+    std::vector<Message> messages;
+
+    void SetUp() override
+    {
+        // Any free port
+        server = lo_server_new(nullptr, nullptr);
+        ASSERT_TRUE(server);
+        lo_server_add_method(server, nullptr, nullptr, &OscOutput::onMessage,
+                             this);
+        lo_server_add_bundle_handlers(server, &OscOutput::onBundle, nullptr,
+                                      this);
+    }
+
+    void TearDown() override
+    {
+        if (server)
+            lo_server_free(server);
+    }
+
+    std::string url() const
+    {
+        return "osc.udp://localhost:" +
+               std::to_string(lo_server_get_port(server)) + "/";
+    }
+
+    void receive(size_t count)
+    {
+        while (messages.size() < count &&
+               lo_server_recv_noblock(server, 1000) > 0)
+        {
+        }
+    }
+
+    static int onMessage(const char* path, const char* types, lo_arg** argv,
+                         int argc, lo_message, void* data)
+    {
+        auto* self = static_cast<OscOutput*>(data);
+        Message message{path, {}};
+        for (int i = 0; i != argc; ++i)
+        {
+            EXPECT_EQ(types[i], 'i');
+            message.arguments.push_back(argv[i]->i);
+        }
+        self->messages.push_back(std::move(message));
+        return 0;
+    }
+
+    static int onBundle(lo_timetag, void* data)
+    {
+        ++static_cast<OscOutput*>(data)->bundles;
+        return 0;
+    }
+};
+} // namespace
+
+TEST_F(OscOutput, one_bundle_per_flush)
+{
+    auto output = io::OscOutput::create({url()});
+    ASSERT_TRUE(output);
+
+    EXPECT_FALSE(output->flush()); // Nothing to send
+    output->send(0, events::PadOutput{3, 100, true});
+    output->send(0, events::KnobOutput{Knob::knob2, 64});
+    output->send(1, events::XyOutput{10, 20});
+    output->send(1, events::WheelOutput{WheelTurn::counterClockwise});
+    EXPECT_FALSE(output->flush());
+
+    receive(4);
+    EXPECT_EQ(bundles, 1);
+    ASSERT_EQ(messages.size(), 4);
+    EXPECT_EQ(messages[0].path, "/paddock/pad");
+    EXPECT_EQ(messages[0].arguments, std::vector<int>({0, 3, 100, 1}));
+    EXPECT_EQ(messages[1].path, "/paddock/knob");
+    EXPECT_EQ(messages[1].arguments, std::vector<int>({0, 1, 64}));
+    EXPECT_EQ(messages[2].path, "/paddock/xy");
+    EXPECT_EQ(messages[2].arguments, std::vector<int>({1, 10, 20}));
+    EXPECT_EQ(messages[3].path, "/paddock/wheel");
+    EXPECT_EQ(messages[3].arguments, std::vector<int>({1, -1}));
+}
+
+TEST_F(OscOutput, overflow)
+{
+    auto output = io::OscOutput::create({url()});
+    ASSERT_TRUE(output);
+
+    for (size_t i = 0; i != io::OscOutput::maxEventsPerBundle + 10; ++i)
+        output->send(0, events::PedalOutput{1});
+    EXPECT_EQ(output->droppedEvents(), 10);
+    EXPECT_FALSE(output->flush());
+
+    receive(io::OscOutput::maxEventsPerBundle);
+    EXPECT_EQ(bundles, 1);
+    EXPECT_EQ(messages.size(), io::OscOutput::maxEventsPerBundle);
+}
+
+TEST_F(OscOutput, invalid_targets)
+{
+    EXPECT_FALSE(io::OscOutput::create({}));
+    EXPECT_FALSE(io::OscOutput::create({"osc.tcp://localhost:9000/"}));
+}
+
+} // namespace paddock
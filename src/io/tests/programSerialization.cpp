@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "io/errors.hpp"
+#include "io/korgPadKontrol/Program.hpp"
+#include "io/korgPadKontrol/Scene.hpp"
+
+namespace paddock
+{
+namespace
+{
+using midi::Mapping;
+using midi::korgPadKontrol::Program;
+using midi::korgPadKontrol::Scene;
+
+Program makeProgram(std::vector<Mapping::Rule> rules)
+{
+    Scene scene{};
+    // The pedal has always fixed velocity
+    scene.pedal.action =
+        Scene::Note{.note = 64, .velocity = midi::Value7bit{127}};
+    scene.roll = {40, 240, 1, 127};
+    scene.flam = {0, 127, 1, 127};
+    scene.pads[3].midiChannel = 9;
+
+    Program program;
+    program.setScene(scene);
+    program.setMapping(*Mapping::compile(std::move(rules)));
+    return program;
+}
+
+const std::vector<Mapping::Rule> rules{
+    {.kind = Mapping::Kind::note,
+     .channel = 9,
+     .low = 36,
+     .high = 47,
+     .outputChannel = 1,
+     .transpose = -12,
+     .valueScale = 150},
+    {.kind = Mapping::Kind::controller,
+     .low = 0,
+     .high = 127,
+     .mute = true},
+    {.kind = Mapping::Kind::note, .outputNumber = 60, .valueScale = 1000}};
+} // namespace
+
+TEST(programSerialization, round_trip)
+{
+    const auto program = makeProgram(rules);
+    const auto bytes = io::korgPadKontrol::serializeProgram(program);
+    ASSERT_TRUE(bytes);
+
+    const auto result = io::korgPadKontrol::deserializeProgram(*bytes);
+    ASSERT_TRUE(result);
+    ASSERT_TRUE(result->scene());
+    EXPECT_EQ(*result->scene(), *program.scene());
+    EXPECT_EQ(result->mapping().rules(), rules);
+}
+
+TEST(programSerialization, without_rules_is_the_scene)
+{
+    const auto program = makeProgram({});
+    const auto bytes = io::korgPadKontrol::serializeProgram(program);
+    ASSERT_TRUE(bytes);
+    EXPECT_EQ(bytes, io::korgPadKontrol::serializeScene(*program.scene()));
+
+    const auto result = io::korgPadKontrol::deserializeProgram(*bytes);
+    ASSERT_TRUE(result);
+    EXPECT_TRUE(result->mapping().rules().empty());
+}
+
+TEST(programSerialization, invalid_mapping)
+{
+    using io::SerializationError;
+    using io::korgPadKontrol::deserializeProgram;
+
+    const auto bytes =
+        *io::korgPadKontrol::serializeProgram(makeProgram(rules));
+    const auto mapping = io::korgPadKontrol::sceneBinarySize;
+
+    auto corrupted = bytes;
+    corrupted[mapping] = 'X';
+    EXPECT_EQ(deserializeProgram(corrupted).error(),
+              SerializationError::invalidHeader);
+
+    corrupted = bytes;
+    corrupted[mapping + 4] = char(io::korgPadKontrol::mappingFormatVersion + 1);
+    EXPECT_EQ(deserializeProgram(corrupted).error(),
+              SerializationError::unsupportedVersion);
+
+    EXPECT_EQ(deserializeProgram(bytes.substr(0, bytes.size() - 1)).error(),
+              SerializationError::invalidSize);
+
+    // A rule out of range, the high note of the first one
+    corrupted = bytes;
+    corrupted[mapping + 7 + 3] = char(128);
+    EXPECT_EQ(deserializeProgram(corrupted).error(),
+              std::errc::invalid_argument);
+}
+
+TEST(programSerialization, no_scene)
+{
+    EXPECT_FALSE(io::korgPadKontrol::serializeProgram(Program{}));
+}
+
+} // namespace paddock
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+namespace paddock::tests
+{
+/// A path in the temporary directory that is unique to the test process, so
+/// that test runs in parallel don't clobber each other's files.
+inline std::string temporaryPath(std::string_view name,
+                                 std::string_view extension = {})
+{
+    return (std::filesystem::temp_directory_path() /
+            ("paddock_" + std::string{name} + "_test_" +
+             std::to_string(::getpid()) + std::string{extension}))
+        .string();
+}
+
+} // namespace paddock::tests
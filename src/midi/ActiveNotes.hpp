@@ -0,0 +1,99 @@
+#pragma once
+
+#include "events.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace paddock::midi
+{
+/// The notes left on in the 16 channels of an output, one bit per note.
+///
+/// Updating the state costs a type check and a bit operation, so it can be
+/// done for every event sent. release emits the exact NoteOffs needed to
+/// silence the output instead of a blanket All Notes Off, which not all the
+/// receivers honour.
+class ActiveNotes
+{
+public:
+    /// Call with every event sent, only NoteOn and NoteOff matter. A NoteOn
+    /// with zero velocity is a NoteOff.
+    void update(const events::Event& event)
+    {
+        if (const auto* on = std::get_if<events::NoteOn>(&event))
+        {
+            if (on->velocity != 0)
+                _set(on->channel, on->note);
+            else
+                _clear(on->channel, on->note);
+        }
+        else if (const auto* off = std::get_if<events::NoteOff>(&event))
+        {
+            _clear(off->channel, off->note);
+        }
+    }
+
+    bool isOn(Value7bit channel, Value7bit note) const
+    {
+        return _words[_word(channel, note)] & _bit(note);
+    }
+
+    bool empty() const
+    {
+        for (const auto word : _words)
+        {
+            if (word != 0)
+                return false;
+        }
+        return true;
+    }
+
+    /// Calls emit with a NoteOff for each note on, in channel and note order,
+    /// and clears the state.
+    template <typename F>
+    void release(F&& emit)
+    {
+        for (size_t i = 0; i != _words.size(); ++i)
+        {
+            auto word = _words[i];
+            _words[i] = 0;
+            while (word != 0)
+            {
+                const auto bit = std::countr_zero(word);
+                word &= word - 1;
+                emit(events::NoteOff{
+                    .channel = Value7bit(i / _wordsPerChannel),
+                    .note = Value7bit((i % _wordsPerChannel) * 64 + bit),
+                    .velocity = 0});
+            }
+        }
+    }
+
+private:
+    static constexpr size_t _wordsPerChannel = 128 / 64;
+
+    std::array<uint64_t, 16 * _wordsPerChannel> _words{};
+
+    static size_t _word(Value7bit channel, Value7bit note)
+    {
+        return (channel & 0x0F) * _wordsPerChannel + ((note & 0x7F) >> 6);
+    }
+
+    static uint64_t _bit(Value7bit note)
+    {
+        return uint64_t(1) << (note & 0x3F);
+    }
+
+    void _set(Value7bit channel, Value7bit note)
+    {
+        _words[_word(channel, note)] |= _bit(note);
+    }
+
+    void _clear(Value7bit channel, Value7bit note)
+    {
+        _words[_word(channel, note)] &= ~_bit(note);
+    }
+};
+
+} // namespace paddock::midi
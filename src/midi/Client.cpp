@@ -24,6 +24,11 @@ std::error_code Client::connectOutput(const ClientInfo& other,
     return _impl->connectOutput(other, inPort);
 }
 
+std::error_code Client::setEventFilter(const EventFilter& filter)
+{
+    return _impl->setEventFilter(filter);
+}
+
 bool Client::hasEvents() const
 {
     return _impl->hasEvents();
@@ -36,7 +41,24 @@ Expected<events::Event> Client::readEvent()
 
 std::error_code Client::postEvent(const events::Event& event)
 {
-    return _impl->postEvent(event);
+    auto error = _impl->postEvent(event);
+    if (!error)
+        _activeNotes.update(event);
+    return error;
+}
+
+std::error_code Client::releaseNotes(
+    const std::function<void(const events::Event&)>* observer)
+{
+    std::error_code result;
+    _activeNotes.release(
+        [this, observer, &result](const events::NoteOff& event) {
+            if (auto error = _impl->postEvent(event))
+                result = error;
+            else if (observer)
+                (*observer)(event);
+        });
+    return result;
 }
 
 std::shared_ptr<void> Client::pollHandle(PollEvents events) const
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "ActiveNotes.hpp"
+#include "EventFilter.hpp"
 #include "PortInfo.hpp"
 #include "events.hpp"
 
 #include "utils/Expected.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -45,7 +48,17 @@ public:
     std::error_code connectInput(const ClientInfo& other, unsigned int outPort);
     std::error_code connectOutput(const ClientInfo& other, unsigned int inPort);
 
+    /// The notes posted are tracked until they are released, posting must
+    /// be done from one thread at a time.
     std::error_code postEvent(const events::Event& event);
+    /// Posts a NoteOff for each note left on, e.g. before closing the client
+    /// or changing what the events posted mean.
+    /// @param observer called with each NoteOff posted
+    std::error_code releaseNotes(
+        const std::function<void(const events::Event&)>* observer = nullptr);
+    /// The events rejected are discarded as early as the platform allows.
+    /// Must not be called while the client is being polled.
+    std::error_code setEventFilter(const EventFilter& filter);
     Expected<events::Event> readEvent();
     bool hasEvents() const;
 
@@ -58,6 +71,7 @@ private:
     template <typename T>
     class Model;
     std::unique_ptr<AbstractClient> _impl;
+    ActiveNotes _activeNotes;
 
     template <typename T>
     Client(Model<T> impl);
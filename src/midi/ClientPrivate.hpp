@@ -13,6 +13,7 @@ public:
                                          unsigned int inPort) = 0;
     virtual std::error_code connectOutput(const ClientInfo& other,
                                           unsigned int outPort) = 0;
+    virtual std::error_code setEventFilter(const EventFilter& filter) = 0;
     virtual bool hasEvents() = 0;
     virtual Expected<events::Event> readEvent() = 0;
     virtual std::error_code postEvent(const events::Event& event) = 0;
@@ -42,6 +43,11 @@ public:
         return _client.connectOutput(other, outPort);
     }
 
+    std::error_code setEventFilter(const EventFilter& filter) final
+    {
+        return _client.setEventFilter(filter);
+    }
+
     bool hasEvents() final { return _client.hasEvents(); }
 
     Expected<events::Event> readEvent() { return _client.readEvent(); }
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace paddock::midi
+{
+/// Interns the clients of an engine by their native number, e.g. the ALSA
+/// client number.
+///
+/// The id of a client is its number plus the generation of its slot, which
+/// changes each time the client leaves, so the id of a client that is gone
+/// never matches the next one with the same number. Lookups are an array
+/// access and nothing is allocated.
+template <size_t Capacity>
+class ClientTable
+{
+public:
+    /// @return the id a new client with the number gets, an invalid one if
+    ///         the number is out of range
+    ClientId makeId(uint32_t number) const
+    {
+        if (number >= Capacity)
+            return ClientId{};
+        const auto& slot = _slots[number];
+        return ClientId{number, slot.used ? slot.generation + 1
+                                          : slot.generation};
+    }
+
+    /// Registers an id returned by makeId, it replaces the client with the
+    /// same number if it didn't leave.
+    void add(const ClientId& id)
+    {
+        if (!id || id.index >= Capacity)
+            return;
+        _slots[id.index] = Slot{id.generation, true};
+    }
+
+    void remove(const ClientId& id)
+    {
+        if (!contains(id))
+            return;
+        auto& slot = _slots[id.index];
+        slot.used = false;
+        ++slot.generation;
+    }
+
+    /// @return the id of the client with the number, an invalid one if there
+    ///         is none
+    ClientId find(uint32_t number) const
+    {
+        if (number >= Capacity || !_slots[number].used)
+            return ClientId{};
+        return ClientId{number, _slots[number].generation};
+    }
+
+    bool contains(const ClientId& id) const
+    {
+        return id && id.index < Capacity && _slots[id.index].used &&
+               _slots[id.index].generation == id.generation;
+    }
+
+    /// Calls the function with the id of every client, in number order.
+    template <typename F>
+    void forEach(F&& function) const
+    {
+        for (uint32_t number = 0; number != Capacity; ++number)
+        {
+            if (_slots[number].used)
+                function(ClientId{number, _slots[number].generation});
+        }
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t generation{0};
+        bool used{false};
+    };
+    std::array<Slot, Capacity> _slots{};
+};
+
+} // namespace paddock::midi
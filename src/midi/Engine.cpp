@@ -7,9 +7,12 @@
 
 #include "platform/alsa/Engine.hpp"
 #include "platform/alsa/Sequencer.hpp"
+#if PADDOCK_USE_JACK
+#include "platform/jack/Engine.hpp"
+#endif
 
 #include "core/Log.hpp"
-#include "core/Poller.hpp"
+#include "core/PollerPool.hpp"
 
 #include "utils/overloaded.hpp"
 
@@ -23,26 +26,19 @@ public:
     AbstractEngine() = default;
 
     AbstractEngine(AbstractEngine&& other)
-        : _poller(std::move(other._poller))
+        : _pollers(std::move(other._pollers))
     {
     }
 
     virtual ~AbstractEngine() {}
+    virtual EngineBackend backend() const = 0;
     virtual std::vector<ClientInfo> queryClientInfos() const = 0;
     virtual std::optional<ClientInfo> queryClientInfo(
         const ClientId& id) const = 0;
     virtual Expected<Client> openClient(const std::string& name,
                                         PortDirection direction) = 0;
 
-    void add(core::PollHandle&& handle, core::PollCallback&& callback)
-    {
-        _poller.add(std::move(handle), std::move(callback));
-    }
-
-    std::future<void> remove(const core::PollHandle& handle)
-    {
-        return _poller.remove(handle);
-    }
+    core::PollerPool& pollers() { return _pollers; }
 
     void setEngineEventCallback(EngineEventCallback callback)
     {
@@ -54,7 +50,7 @@ protected:
     EngineEventCallback _eventCallback;
 
 private:
-    core::Poller _poller;
+    core::PollerPool _pollers;
 };
 
 template <typename T>
@@ -67,8 +63,21 @@ public:
         auto handle = _engine.pollHandle();
         if (handle)
         {
-            add(std::move(handle),
-                [this](const void*, int) { _processClientEvents(); });
+            // The announcements can wait, they must not delay the devices,
+            // which are polled from shards of their own.
+            core::ThreadOptions options;
+            options.name = "paddock-engine";
+            options.policy = core::ThreadOptions::Policy::background;
+            if (auto error = pollers().setThreadOptions(
+                    core::PollerPool::defaultShard, options))
+            {
+                core::log() << "Could not lower the priority of the engine "
+                               "thread: "
+                            << error.message();
+            }
+            pollers().add(std::move(handle), [this](const void*, int) {
+                _processClientEvents();
+            });
         }
     }
 
@@ -76,11 +85,15 @@ public:
     {
         auto handle = _engine.pollHandle();
         if (handle)
-            remove(handle).wait();
+        {
+            pollers().remove(handle).wait();
+        }
     }
 
     Model(Model&& other) = default;
 
+    EngineBackend backend() const final { return T::backend; }
+
     std::vector<ClientInfo> queryClientInfos() const final
     {
         return _engine.queryClientInfos();
@@ -127,15 +140,38 @@ private:
 Expected<Engine> Engine::create()
 {
 #if PADDOCK_USE_ALSA
-    return alsa::Engine::create().and_then(
-        [](alsa::Engine&& engine) -> Expected<Engine> {
-            return Engine{std::move(engine)};
-        });
+    return create(EngineBackend::alsa);
 #else
-    return tl::make_unexpected(EngineError::noEngineAvailable);
+    return create(EngineBackend::jack);
 #endif
 }
 
+Expected<Engine> Engine::create(EngineBackend backend)
+{
+    switch (backend)
+    {
+    case EngineBackend::alsa:
+#if PADDOCK_USE_ALSA
+        return alsa::Engine::create().and_then(
+            [](alsa::Engine&& engine) -> Expected<Engine> {
+                return Engine{std::move(engine)};
+            });
+#else
+        break;
+#endif
+    case EngineBackend::jack:
+#if PADDOCK_USE_JACK
+        return jack::Engine::create().and_then(
+            [](jack::Engine&& engine) -> Expected<Engine> {
+                return Engine{std::move(engine)};
+            });
+#else
+        break;
+#endif
+    }
+    return tl::make_unexpected(EngineError::noEngineAvailable);
+}
+
 template <typename T>
 Engine::Engine(T&& engine)
     : _impl{new Model{std::move(engine)}}
@@ -146,6 +182,11 @@ Engine::~Engine() = default;
 Engine::Engine(Engine&& other) = default;
 Engine& Engine::operator=(Engine&& other) = default;
 
+EngineBackend Engine::backend() const
+{
+    return _impl->backend();
+}
+
 std::vector<ClientInfo> Engine::queryClientInfos() const
 {
     return _impl->queryClientInfos();
@@ -190,14 +231,45 @@ Expected<Pad> Engine::connect(const std::string& clientName,
     return tl::make_unexpected(EngineError::noDeviceFound);
 }
 
-void Engine::add(core::PollHandle handle, core::PollCallback callback)
+Engine::Shard Engine::addShard(const core::ThreadOptions& options)
+{
+    auto& pollers = _impl->pollers();
+    const auto shard = pollers.addShard();
+    if (auto error = pollers.setThreadOptions(shard, options))
+    {
+        core::log() << "Could not set the options of the thread "
+                    << options.name << ": " << error.message();
+    }
+    return shard;
+}
+
+void Engine::removeShard(Shard shard)
+{
+    _impl->pollers().removeShard(shard);
+}
+
+void Engine::add(core::PollHandle handle, core::PollCallback callback,
+                 Shard shard)
+{
+    _impl->pollers().add(std::move(handle), std::move(callback), shard);
+}
+
+Expected<core::PollHandle> Engine::addTimer(std::chrono::nanoseconds delay,
+                                            std::chrono::nanoseconds period,
+                                            core::Task callback, Shard shard)
+{
+    return _impl->pollers().addTimer(delay, period, std::move(callback),
+                                     shard);
+}
+
+void Engine::post(core::Task task, Shard shard)
 {
-    _impl->add(std::move(handle), std::move(callback));
+    _impl->pollers().post(std::move(task), shard);
 }
 
 std::future<void> Engine::remove(const core::PollHandle& handle)
 {
-    return _impl->remove(std::move(handle));
+    return _impl->pollers().remove(handle);
 }
 
 void Engine::setEngineEventCallback(EngineEventCallback callback)
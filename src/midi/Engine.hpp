@@ -2,7 +2,7 @@
 
 #include "Client.hpp"
 
-#include "core/Poller.hpp"
+#include "core/PollerPool.hpp"
 
 #include "pads/pads.hpp"
 
@@ -25,7 +25,9 @@ public:
     template <typename T>
     class Model;
 
+    /// Creates an engine of the first backend available, ALSA is preferred.
     static Expected<Engine> create();
+    static Expected<Engine> create(EngineBackend backend);
 
     ~Engine();
 
@@ -35,6 +37,8 @@ public:
     Engine(const Engine& other) = delete;
     Engine& operator=(const Engine& other) = delete;
 
+    EngineBackend backend() const;
+
     // Get the infomation about all the clients in the system
     std::vector<ClientInfo> queryClientInfos() const;
 
@@ -54,7 +58,24 @@ public:
     Expected<Pad> connect(const std::string& clientName,
                           const ClientInfo& deviceInfo);
 
-    void add(core::PollHandle handle, core::PollCallback callback);
+    using Shard = core::PollerPool::Shard;
+
+    /// Adds a poller thread for the handles that mustn't wait for the
+    /// others, e.g. the inputs of a device. The options that can't be
+    /// applied are logged, the thread runs anyway.
+    Shard addShard(const core::ThreadOptions& options);
+    /// It mustn't be called from the shard itself.
+    void removeShard(Shard shard);
+
+    /// The handles, timers and tasks of a shard run in the same thread, see
+    /// core::PollerPool. The default shard also polls the client
+    /// announcements, with a background priority.
+    void add(core::PollHandle handle, core::PollCallback callback,
+             Shard shard = core::PollerPool::defaultShard);
+    Expected<core::PollHandle> addTimer(
+        std::chrono::nanoseconds delay, std::chrono::nanoseconds period,
+        core::Task callback, Shard shard = core::PollerPool::defaultShard);
+    void post(core::Task task, Shard shard = core::PollerPool::defaultShard);
     std::future<void> remove(const core::PollHandle& handle);
 
     void setEngineEventCallback(EngineEventCallback callback);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "events.hpp"
+
+#include "utils/mp.hpp"
+
+#include <bitset>
+#include <cstdint>
+
+namespace paddock::midi
+{
+/// Selects the events a client reads by type and, for the channel events,
+/// by channel.
+///
+/// The backends compile it to their native event types to discard the
+/// unwanted events before converting them, or to push the filter down to the
+/// system when possible so they never wake up the poll thread.
+class EventFilter
+{
+public:
+    static constexpr size_t typeCount = std::variant_size_v<events::Event>;
+
+    /// Accepts everything
+    EventFilter() { _types.set(); }
+
+    /// Accepts nothing, to accept only some types.
+    static EventFilter none()
+    {
+        EventFilter filter;
+        filter._types.reset();
+        return filter;
+    }
+
+    template <typename... T>
+    EventFilter& accept()
+    {
+        (_types.set(mp::indexOf<T, events::MidiTypes>), ...);
+        return *this;
+    }
+
+    template <typename... T>
+    EventFilter& reject()
+    {
+        (_types.reset(mp::indexOf<T, events::MidiTypes>), ...);
+        return *this;
+    }
+
+    /// Bit n accepts channel n, the events without channel aren't affected.
+    EventFilter& setChannels(uint16_t mask)
+    {
+        _channels = mask;
+        return *this;
+    }
+
+    uint16_t channels() const { return _channels; }
+
+    /// @param index the index of the type in events::Event
+    bool acceptsType(size_t index) const { return _types.test(index); }
+
+    bool acceptsAll() const { return _types.all() && _channels == 0xFFFF; }
+
+    bool accepts(const events::Event& event) const
+    {
+        if (!_types.test(event.index()))
+            return false;
+        return std::visit(
+            [this](const auto& e) {
+                if constexpr (requires { e.channel; })
+                    return acceptsChannel(e.channel);
+                else
+                    return true;
+            },
+            event);
+    }
+
+    bool acceptsChannel(unsigned int channel) const
+    {
+        return _channels & (1 << (channel & 0x0F));
+    }
+
+private:
+    std::bitset<typeCount> _types;
+    uint16_t _channels{0xFFFF};
+};
+
+} // namespace paddock::midi
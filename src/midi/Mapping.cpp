@@ -1,9 +1,105 @@
-#include "Mapping"
+#include "Mapping.hpp"
+
+#include <map>
 
 namespace paddock::midi
 {
-class Mapping
+namespace
+{
+constexpr std::size_t kindCount = 2;
+constexpr std::size_t channelCount = 16;
+constexpr std::size_t numberCount = 128;
+
+bool isValid(const Mapping::Rule& rule)
+{
+    return (rule.kind == Mapping::Kind::note ||
+            rule.kind == Mapping::Kind::controller) &&
+           (!rule.channel || *rule.channel < channelCount) &&
+           rule.low <= rule.high && rule.high < numberCount &&
+           (!rule.outputChannel || *rule.outputChannel < channelCount) &&
+           (!rule.outputNumber || *rule.outputNumber < numberCount) &&
+           rule.transpose > -int(numberCount) &&
+           rule.transpose < int(numberCount) && rule.valueScale >= 0 &&
+           rule.valueScale <= 1000;
+}
+
+bool matches(const Mapping::Rule& rule, Mapping::Kind kind,
+             Value7bit channel, Value7bit number)
+{
+    return rule.kind == kind && (!rule.channel || *rule.channel == channel) &&
+           rule.low <= number && number <= rule.high;
+}
+} // namespace
+
+Expected<Mapping> Mapping::compile(std::vector<Rule> rules)
+{
+    for (const auto& rule : rules)
+    {
+        if (!isValid(rule))
+            return tl::make_unexpected(
+                std::make_error_code(std::errc::invalid_argument));
+    }
+
+    Mapping mapping;
+    mapping._rules = std::move(rules);
+    if (mapping._rules.empty())
+        return mapping;
+
+    // Unmatched events are emitted as they are.
+    mapping._code.push_back({_Op::emit});
+    mapping._code.push_back({_Op::end});
+
+    // Entries matched by the same rules share their code, there are few
+    // distinct sets in practice.
+    std::map<std::vector<std::size_t>, std::uint32_t> programs;
+    programs.emplace(std::vector<std::size_t>{}, 0);
+
+    mapping._table.resize(kindCount * channelCount * numberCount);
+    std::vector<std::size_t> matched;
+    for (auto kind : {Kind::note, Kind::controller})
+    {
+        for (Value7bit channel = 0; channel != channelCount; ++channel)
+        {
+            for (Value7bit number = 0; number != numberCount; ++number)
+            {
+                matched.clear();
+                for (std::size_t i = 0; i != mapping._rules.size(); ++i)
+                {
+                    if (matches(mapping._rules[i], kind, channel, number))
+                        matched.push_back(i);
+                }
+
+                auto [program, inserted] = programs.emplace(
+                    matched, std::uint32_t(mapping._code.size()));
+                if (inserted)
+                {
+                    for (auto i : matched)
+                        mapping._compileRule(mapping._rules[i]);
+                    mapping._code.push_back({_Op::end});
+                }
+                mapping._table[_index(kind, channel, number)] =
+                    program->second;
+            }
+        }
+    }
+
+    return mapping;
+}
+
+void Mapping::_compileRule(const Rule& rule)
 {
-};
+    if (rule.mute)
+        return;
+
+    if (rule.outputChannel)
+        _code.push_back({_Op::channel, std::int16_t(*rule.outputChannel)});
+    if (rule.outputNumber)
+        _code.push_back({_Op::number, std::int16_t(*rule.outputNumber)});
+    else if (rule.transpose != 0)
+        _code.push_back({_Op::transpose, std::int16_t(rule.transpose)});
+    if (rule.valueScale != 100)
+        _code.push_back({_Op::scale, std::int16_t(rule.valueScale)});
+    _code.push_back({_Op::emit});
+}
 
 } // namespace paddock::midi
@@ -1,9 +1,179 @@
 #pragma once
 
+#include "events.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
 namespace paddock::midi
 {
+/// Routes and transforms the voice and controller events of a program.
+///
+/// The rules are compiled into a table indexed by event kind, channel and
+/// note or controller number. Each entry points to the bytecode of all the
+/// rules matching it, so applying a mapping costs the same regardless of the
+/// number of rules. Events that no rule matches pass through unchanged.
 class Mapping
 {
+public:
+    enum class Kind : unsigned char
+    {
+        note, // NoteOn, NoteOff and KeyPressure
+        controller
+    };
+
+    struct Rule
+    {
+        Kind kind{Kind::note};
+        /// 0-15, all channels if not set
+        std::optional<Value7bit> channel;
+        /// Range of notes or controller parameters matched. Rules with
+        /// disjoint ranges split the keyboard.
+        Value7bit low{0};
+        Value7bit high{127};
+
+        /// Discards the events matched
+        bool mute{false};
+        std::optional<Value7bit> outputChannel;
+        /// Replaces the note or parameter, otherwise it's transposed. Events
+        /// transposed out of 0-127 are dropped.
+        std::optional<Value7bit> outputNumber;
+        int transpose{0};
+        /// Percentage applied to the velocity or controller value
+        int valueScale{100};
+
+        bool operator==(const Rule& other) const = default;
+    };
+
+    /// Passes all the events through.
+    Mapping() = default;
+
+    /// Rules matching the same event are layered, each one emits its own
+    /// event in the order given.
+    /// @return std::errc::invalid_argument if any value is out of range
+    static Expected<Mapping> compile(std::vector<Rule> rules);
+
+    const std::vector<Rule>& rules() const { return _rules; }
+
+    /// Calls emit with each event resulting from event.
+    template <typename F>
+    void apply(const events::Event& event, F&& emit) const;
+
+private:
+    enum class _Op : unsigned char
+    {
+        channel,
+        number,
+        transpose,
+        scale,
+        emit,
+        end
+    };
+
+    struct _Instruction
+    {
+        _Op op;
+        std::int16_t argument{0};
+    };
+
+    std::vector<Rule> _rules;
+    /// Offsets into _code, empty if there are no rules
+    std::vector<std::uint32_t> _table;
+    std::vector<_Instruction> _code;
+
+    static std::size_t _index(Kind kind, Value7bit channel, Value7bit number)
+    {
+        return ((std::size_t(kind) << 4 | (channel & 0x0F)) << 7) |
+               (number & 0x7F);
+    }
+
+    void _compileRule(const Rule& rule);
+
+    template <typename T, typename F>
+    void _run(const T& input, Kind kind, Value7bit T::*number,
+              Value7bit T::*value, F& emit) const;
 };
 
+template <typename F>
+void Mapping::apply(const events::Event& event, F&& emit) const
+{
+    if (_table.empty())
+    {
+        emit(event);
+        return;
+    }
+
+    std::visit(
+        [this, &event, &emit](const auto& input) {
+            using T = std::decay_t<decltype(input)>;
+            if constexpr (std::is_same_v<T, events::NoteOn> ||
+                          std::is_same_v<T, events::NoteOff> ||
+                          std::is_same_v<T, events::KeyPressure>)
+            {
+                _run(input, Kind::note, &T::note, &T::velocity, emit);
+            }
+            else if constexpr (std::is_same_v<T, events::Controller>)
+            {
+                _run(input, Kind::controller, &T::parameter, &T::value, emit);
+            }
+            else
+            {
+                emit(event);
+            }
+        },
+        event);
+}
+
+template <typename T, typename F>
+void Mapping::_run(const T& input, Kind kind, Value7bit T::*number,
+                   Value7bit T::*value, F& emit) const
+{
+    const auto* instruction =
+        &_code[_table[_index(kind, input.channel, input.*number)]];
+    T output = input;
+    bool dropped = false;
+    for (;; ++instruction)
+    {
+        const int argument = instruction->argument;
+        switch (instruction->op)
+        {
+        case _Op::channel:
+            output.channel = Value7bit(argument);
+            break;
+        case _Op::number:
+            output.*number = Value7bit(argument);
+            break;
+        case _Op::transpose:
+        {
+            const int result = input.*number + argument;
+            dropped = result < 0 || result > 127;
+            output.*number = Value7bit(result);
+            break;
+        }
+        case _Op::scale:
+        {
+            const int result = input.*value * argument / 100;
+            // A note on with velocity 0 would become a note off.
+            const int min = kind == Kind::note && input.*value != 0 ? 1 : 0;
+            output.*value = Value7bit(std::clamp(result, min, 127));
+            break;
+        }
+        case _Op::emit:
+            if (!dropped)
+                emit(events::Event{output});
+            output = input;
+            dropped = false;
+            break;
+        case _Op::end:
+            return;
+        }
+    }
+}
+
 } // namespace paddock::midi
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "enums.hpp"
+#include "types.hpp"
 
-#include <memory>
 #include <string>
 
 namespace paddock::midi
@@ -16,7 +16,7 @@ struct PortInfo
     PortType type;
 
     // Client ID of the ClientInfo to which this port belongs
-    std::shared_ptr<void> clientId;
+    ClientId clientId;
 
     // Hardware device identifier to use for opening a raw midi connection
     // to this port
@@ -9,7 +9,10 @@
 
 namespace paddock::midi
 {
-template <size_t maxMessageSize>
+/// Splits the byte stream read from a device into SysEx messages.
+/// DeviceType only needs to provide read(span) and hasAvailableInput(), which
+/// allows feeding the tokenizer from memory (e.g. in benchmarks).
+template <size_t maxMessageSize, typename DeviceType = Device>
 class SysExStreamTokenizer
 {
 public:
@@ -19,7 +22,7 @@ public:
         _currentMessage.reserve(maxMessageSize);
     }
 
-    void reset(Device* device)
+    void reset(DeviceType* device)
     {
         _device = device;
         _readErrorState = false;
@@ -78,7 +81,7 @@ public:
     }
 
 private:
-    Device* _device{nullptr};
+    DeviceType* _device{nullptr};
 
     std::vector<std::byte> _receiveBuffer;
     std::vector<std::byte> _currentMessage;
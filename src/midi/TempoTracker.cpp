@@ -0,0 +1,114 @@
+#include "TempoTracker.hpp"
+
+#include "utils/overloaded.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace paddock::midi
+{
+namespace
+{
+// Longer gaps between ticks restart the loop, 10 bpm at most.
+constexpr double maxPeriod = 60.0 / 10 / TempoTracker::ticksPerQuarterNote;
+
+double seconds(TempoTracker::Clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+} // namespace
+
+double TempoTracker::State::positionAt(Clock::time_point now) const
+{
+    if (!running || beatsPerMinute == 0)
+        return position;
+    return position + seconds(now - time) * beatsPerMinute / 60;
+}
+
+double TempoTracker::State::phaseAt(Clock::time_point now) const
+{
+    const auto current = positionAt(now);
+    return current - std::floor(current);
+}
+
+bool TempoTracker::process(const events::Event& event, Clock::time_point time)
+{
+    const bool consumed = std::visit(
+        overloaded{[this, time](const events::Clock&) {
+                       _tick(time);
+                       return true;
+                   },
+                   [this](const events::Start&) {
+                       _nextTick = 0;
+                       _state.position = 0;
+                       _state.running = true;
+                       return true;
+                   },
+                   [this](const events::Continue&) {
+                       _state.running = true;
+                       return true;
+                   },
+                   [this](const events::Stop&) {
+                       _state.running = false;
+                       return true;
+                   },
+                   [this](const events::SongPosition& e) {
+                       // 1 MIDI beat = 6 clocks
+                       _nextTick = int64_t(e.beats) * 6;
+                       _state.position =
+                           double(_nextTick) / ticksPerQuarterNote;
+                       return true;
+                   },
+                   [](const auto&) { return false; }},
+        event);
+
+    if (consumed)
+        _published.write(_state);
+    return consumed;
+}
+
+void TempoTracker::_tick(Clock::time_point time)
+{
+    // See F. Adriaensen, Using a DLL to filter time, 2005. The times are
+    // kept relative to the filtered time of the last tick to keep the
+    // precision of the doubles.
+    const double elapsed = _started ? seconds(time - _lastTick) : 0;
+    if (!_started || elapsed > maxPeriod)
+    {
+        _started = true;
+        _lastTick = time;
+        _nextTickTime = 0;
+        _period = 0;
+    }
+    else if (_period == 0)
+    {
+        // The first interval initializes the loop.
+        if (elapsed > 0)
+            _period = elapsed;
+        _lastTick = time;
+        _nextTickTime = _period;
+    }
+    else
+    {
+        const double omega = 2 * std::numbers::pi * _bandwidth * _period;
+        const double error = elapsed - _nextTickTime;
+        _lastTick += std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(_nextTickTime));
+        _nextTickTime = std::numbers::sqrt2 * omega * error + _period;
+        _period += omega * omega * error;
+        // Only possible with a wildly irregular clock, start over.
+        if (_period <= 0)
+            _started = false;
+    }
+
+    _state.time = _lastTick;
+    _state.beatsPerMinute =
+        _period > 0 ? 60 / (_period * ticksPerQuarterNote) : 0;
+    if (_state.running)
+    {
+        _state.position = double(_nextTick) / ticksPerQuarterNote;
+        ++_nextTick;
+    }
+}
+
+} // namespace paddock::midi
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "events.hpp"
+
+#include "utils/TripleBuffer.hpp"
+
+#include <chrono>
+
+namespace paddock::midi
+{
+/// Follows the tempo and song position of an external MIDI clock.
+///
+/// The arrival times of the 24 ppqn clock ticks are smoothed with a second
+/// order delay locked loop, which filters the jitter of the transport and the
+/// scheduler while following tempo changes in about a second. The state is
+/// published on every tick and can be read without blocking, e.g. from the
+/// MIDI thread to quantize or to blink a LED on the beat.
+///
+/// process must be called from one thread at a time and state from one
+/// thread at a time, both can be the same one.
+class TempoTracker
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int ticksPerQuarterNote = 24;
+
+    struct State
+    {
+        /// Between Start or Continue and Stop
+        bool running{false};
+        /// Zero until two consecutive ticks have been received
+        double beatsPerMinute{0};
+        /// Quarter notes since the song start at time
+        double position{0};
+        /// The filtered time of the last tick
+        Clock::time_point time;
+
+        /// @return the position extrapolated to another time, it doesn't
+        /// move while stopped
+        double positionAt(Clock::time_point now) const;
+        /// @return the fraction of quarter note at a time, in [0, 1)
+        double phaseAt(Clock::time_point now) const;
+    };
+
+    /// Ignores the events that aren't Clock, Start, Continue, Stop or
+    /// SongPosition.
+    /// @param time the time at which the event was received
+    /// @return true if the event was consumed
+    bool process(const events::Event& event, Clock::time_point time);
+    bool process(const events::Event& event)
+    {
+        return process(event, Clock::now());
+    }
+
+    State state() { return _published.read(); }
+
+private:
+    // The loop bandwidth in Hz, lower is smoother but slower to follow.
+    static constexpr double _bandwidth = 1.0;
+
+    // Loop state, in seconds
+    bool _started{false};
+    Clock::time_point _lastTick;
+    double _nextTickTime{0}; // Predicted, relative to _lastTick
+    double _period{0};       // Zero until the first interval is measured
+
+    // Ticks since the song start of the next tick while running
+    int64_t _nextTick{0};
+    State _state;
+
+    TripleBuffer<State> _published;
+
+    void _tick(Clock::time_point time);
+};
+
+} // namespace paddock::midi
@@ -8,6 +8,12 @@ enum class ClientType
     system
 };
 
+enum class EngineBackend
+{
+    alsa,
+    jack
+};
+
 enum class PollEvents
 {
     in,
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "utils/byte.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+/// Building blocks to describe the layout of a binary data dump (e.g. a
+/// scene) as a list of fields, from which the encoder, decoder, validator and
+/// diff are generated at compile time.
+///
+/// A field is a type with the following static members:
+/// - path: a constant that identifies the field
+/// - encode(const Model&, std::span<std::byte>): encodes the field into a
+///   zero initialized payload.
+/// - decode(std::span<const std::byte>, Model&). Fields are decoded in order,
+///   so a field can depend on the fields that precede it.
+/// - validate(const Model&) -> bool
+/// - equal(const Model&, const Model&) -> bool
+///
+/// All byte and bit positions are template arguments, so the generated code
+/// has no lookup tables nor loops.
+namespace paddock::midi::layout
+{
+struct Bit
+{
+    int byte;
+    int bit;
+};
+
+template <Bit bit>
+bool test(std::span<const std::byte> payload)
+{
+    return (payload[bit.byte] & (1_b << bit.bit)) != 0_b;
+}
+
+template <Bit bit>
+void set(std::span<std::byte> payload, bool value)
+{
+    payload[bit.byte] |= std::byte(value) << bit.bit;
+}
+
+/// Base for fields whose value is a data member of an object of the model.
+/// Access must provide get(Model&) and get(const Model&) overloads returning
+/// the object.
+template <auto fieldPath, typename Access, auto member>
+struct Member
+{
+    static constexpr auto path = fieldPath;
+
+    template <typename Model>
+    static auto& value(Model& model)
+    {
+        return Access::get(model).*member;
+    }
+
+    template <typename Model>
+    static bool equal(const Model& lhs, const Model& rhs)
+    {
+        return value(lhs) == value(rhs);
+    }
+};
+
+/// A boolean or a two valued enum (0 and 1) stored in a bit.
+template <auto path, typename Access, auto member, Bit bit>
+struct Flag : Member<path, Access, member>
+{
+    using Base = Member<path, Access, member>;
+
+    template <typename Model>
+    static void encode(const Model& model, std::span<std::byte> payload)
+    {
+        set<bit>(payload, static_cast<int>(Base::value(model)) != 0);
+    }
+
+    template <typename Model>
+    static void decode(std::span<const std::byte> payload, Model& model)
+    {
+        auto& value = Base::value(model);
+        value = static_cast<std::remove_reference_t<decltype(value)>>(
+            test<bit>(payload));
+    }
+
+    template <typename Model>
+    static bool validate(const Model&)
+    {
+        return true;
+    }
+};
+
+/// A 7-bit value stored in a data byte.
+template <auto path, typename Access, auto member, int byte>
+struct Byte : Member<path, Access, member>
+{
+    using Base = Member<path, Access, member>;
+
+    template <typename Model>
+    static void encode(const Model& model, std::span<std::byte> payload)
+    {
+        payload[byte] = static_cast<std::byte>(Base::value(model));
+    }
+
+    template <typename Model>
+    static void decode(std::span<const std::byte> payload, Model& model)
+    {
+        auto& value = Base::value(model);
+        value = static_cast<std::remove_reference_t<decltype(value)>>(
+            payload[byte]);
+    }
+
+    template <typename Model>
+    static bool validate(const Model& model)
+    {
+        return static_cast<unsigned>(Base::value(model)) <= 0x7F;
+    }
+};
+
+/// An 8-bit value stored as 7 bits in a data byte plus the most significant
+/// bit somewhere else, with an optional valid range.
+template <auto path, typename Access, auto member, int byte, Bit high,
+          unsigned min = 0, unsigned max = 0xFF>
+struct SplitByte : Member<path, Access, member>
+{
+    using Base = Member<path, Access, member>;
+
+    template <typename Model>
+    static void encode(const Model& model, std::span<std::byte> payload)
+    {
+        const auto value = static_cast<unsigned>(Base::value(model));
+        payload[byte] = static_cast<std::byte>(value & 0x7F);
+        set<high>(payload, value & 0x80);
+    }
+
+    template <typename Model>
+    static void decode(std::span<const std::byte> payload, Model& model)
+    {
+        auto& value = Base::value(model);
+        value = static_cast<std::remove_reference_t<decltype(value)>>(
+            static_cast<unsigned>(payload[byte]) |
+            (unsigned(test<high>(payload)) << 7));
+    }
+
+    template <typename Model>
+    static bool validate(const Model& model)
+    {
+        const auto value = static_cast<unsigned>(Base::value(model));
+        return value >= min && value <= max;
+    }
+};
+
+/// An unsigned integer whose bits are scattered, bits[0] being the least
+/// significant one.
+template <auto path, typename Access, auto member, auto bits>
+struct Bits : Member<path, Access, member>
+{
+    using Base = Member<path, Access, member>;
+    using Indices = std::make_index_sequence<bits.size()>;
+
+    template <typename Model>
+    static void encode(const Model& model, std::span<std::byte> payload)
+    {
+        const auto value = static_cast<unsigned>(Base::value(model));
+        [&]<size_t... i>(std::index_sequence<i...>)
+        {
+            (set<bits[i]>(payload, (value >> i) & 1), ...);
+        }
+        (Indices{});
+    }
+
+    template <typename Model>
+    static void decode(std::span<const std::byte> payload, Model& model)
+    {
+        auto& value = Base::value(model);
+        value = [&]<size_t... i>(std::index_sequence<i...>)
+        {
+            return static_cast<std::remove_reference_t<decltype(value)>>(
+                ((unsigned(test<bits[i]>(payload)) << i) | ...));
+        }
+        (Indices{});
+    }
+
+    template <typename Model>
+    static bool validate(const Model& model)
+    {
+        return static_cast<unsigned>(Base::value(model)) >> bits.size() == 0;
+    }
+};
+
+/// The codec generated from a list of fields.
+template <typename Model, typename... Fields>
+struct Codec
+{
+    static constexpr size_t fieldCount = sizeof...(Fields);
+
+    /// Bit i is set when field i differs.
+    using Diff = std::bitset<fieldCount>;
+
+    static constexpr std::array paths{Fields::path...};
+
+    /// @param payload A zero initialized payload
+    static void encode(const Model& model, std::span<std::byte> payload)
+    {
+        (Fields::encode(model, payload), ...);
+    }
+
+    static void decode(std::span<const std::byte> payload, Model& model)
+    {
+        (Fields::decode(payload, model), ...);
+    }
+
+    static bool validate(const Model& model)
+    {
+        return (Fields::validate(model) && ...);
+    }
+
+    static Diff diff(const Model& lhs, const Model& rhs)
+    {
+        Diff diff;
+        size_t i = 0;
+        ((diff[i++] = !Fields::equal(lhs, rhs)), ...);
+        return diff;
+    }
+};
+
+} // namespace paddock::midi::layout
@@ -0,0 +1,113 @@
+#include "messages.hpp"
+
+#include "utils/overloaded.hpp"
+
+namespace paddock::midi
+{
+namespace
+{
+ShortMessage makeMessage(int status, int channel, int data1, int data2 = -1)
+{
+    return ShortMessage{{uint8_t(status | (channel & 0x0F)),
+                         uint8_t(data1 & 0x7F), uint8_t(data2 & 0x7F)},
+                        uint8_t(data2 < 0 ? 2 : 3)};
+}
+} // namespace
+
+std::optional<ShortMessage> encodeShortMessage(const events::Event& event)
+{
+    using namespace events;
+    return std::visit(
+        overloaded{
+            [](const NoteOn& e) -> std::optional<ShortMessage> {
+                return makeMessage(0x90, e.channel, e.note, e.velocity);
+            },
+            [](const NoteOff& e) -> std::optional<ShortMessage> {
+                return makeMessage(0x80, e.channel, e.note, e.velocity);
+            },
+            [](const KeyPressure& e) -> std::optional<ShortMessage> {
+                return makeMessage(0xA0, e.channel, e.note, e.velocity);
+            },
+            [](const Controller& e) -> std::optional<ShortMessage> {
+                return makeMessage(0xB0, e.channel, e.parameter, e.value);
+            },
+            [](const ProgramChange& e) -> std::optional<ShortMessage> {
+                return makeMessage(0xC0, e.channel, e.program);
+            },
+            [](const ChannelPressure& e) -> std::optional<ShortMessage> {
+                return makeMessage(0xD0, e.channel, e.pressure);
+            },
+            [](const PitchBend& e) -> std::optional<ShortMessage> {
+                const int value = e.value + 8192;
+                return makeMessage(0xE0, e.channel, value, value >> 7);
+            },
+            [](const auto&) -> std::optional<ShortMessage> {
+                return std::nullopt;
+            }},
+        event);
+}
+
+namespace
+{
+std::optional<events::Event> decodeSystemMessage(
+    std::span<const uint8_t> message)
+{
+    switch (message[0])
+    {
+    case 0xF2:
+        if (message.size() < 3)
+            return std::nullopt;
+        return events::SongPosition{
+            UValue14bit((message[2] & 0x7F) << 7 | (message[1] & 0x7F))};
+    case 0xF8:
+        return events::Clock{};
+    case 0xFA:
+        return events::Start{};
+    case 0xFB:
+        return events::Continue{};
+    case 0xFC:
+        return events::Stop{};
+    default:
+        return std::nullopt;
+    }
+}
+} // namespace
+
+std::optional<events::Event> decodeShortMessage(
+    std::span<const uint8_t> message)
+{
+    if (message.empty() || (message[0] & 0x80) == 0)
+        return std::nullopt;
+    if (message[0] >= 0xF0)
+        return decodeSystemMessage(message);
+
+    const auto status = message[0] & 0xF0;
+    const size_t size = (status == 0xC0 || status == 0xD0) ? 2 : 3;
+    if (message.size() < size)
+        return std::nullopt;
+
+    const Value7bit channel = message[0] & 0x0F;
+    const Value7bit data1 = message[1] & 0x7F;
+    const Value7bit data2 = size == 3 ? message[2] & 0x7F : 0;
+    switch (status)
+    {
+    case 0x80:
+        return events::NoteOff{channel, data1, data2};
+    case 0x90:
+        return events::NoteOn{channel, data1, data2};
+    case 0xA0:
+        return events::KeyPressure{channel, data1, data2};
+    case 0xB0:
+        return events::Controller{
+            .channel = channel, .value = data2, .parameter = data1};
+    case 0xC0:
+        return events::ProgramChange{channel, data1};
+    case 0xD0:
+        return events::ChannelPressure{channel, data1};
+    default: // 0xE0
+        return events::PitchBend{channel,
+                                 Value14bit((data2 << 7 | data1) - 8192)};
+    }
+}
+
+} // namespace paddock::midi
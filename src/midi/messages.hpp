@@ -0,0 +1,31 @@
+#pragma once
+
+#include "events.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace paddock::midi
+{
+/// A channel voice message as it's sent over a MIDI cable, the format used
+/// by Standard MIDI Files and by the JACK MIDI ports.
+struct ShortMessage
+{
+    std::array<uint8_t, 3> data;
+    uint8_t size;
+};
+
+/// Only the voice and channel events have a short message, the others return
+/// std::nullopt.
+std::optional<ShortMessage> encodeShortMessage(const events::Event& event);
+
+/// Running status isn't supported, the message must start with a status
+/// byte. Besides the voice messages, the clock and the song position are
+/// decoded, e.g. to follow the tempo of a JACK MIDI port.
+/// @return std::nullopt if the bytes aren't a complete message of those
+std::optional<events::Event> decodeShortMessage(
+    std::span<const uint8_t> message);
+
+} // namespace paddock::midi
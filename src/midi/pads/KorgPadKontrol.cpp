@@ -8,6 +8,7 @@
 #include "midi/Client.hpp"
 #include "midi/Device.hpp"
 #include "midi/Engine.hpp"
+#include "midi/EventFilter.hpp"
 #include "midi/SysExStreamTokenizer.hpp"
 #include "midi/errors.hpp"
 
@@ -15,9 +16,13 @@
 #include "core/errors.hpp"
 
 #include "utils/Expected.hpp"
+#include "utils/RcuPointer.hpp"
 #include "utils/overloaded.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <future>
 #include <mutex>
 
 #include "korgPadKontrol/scenePrinters.hpp"
@@ -48,6 +53,8 @@ class PadKontrolErrorCategory : public std::error_category
             return "Device not recognized as KORG PadKontrol";
         case Error::packetCommunicationError:
             return "Packet Communication Command Error";
+        case Error::unsupportedMode:
+            return "Mode not supported by the MIDI engine";
         default:
             throw std::logic_error("Unknown error code");
         }
@@ -61,6 +68,17 @@ class PadKontrolErrorCategory : public std::error_category
 
 const PadKontrolErrorCategory padKontrolErrorCategory{};
 
+// Below the threaded interrupt handlers (50 in Linux), the USB MIDI data
+// comes from them.
+const core::ThreadOptions threadOptions{
+    .name = "paddock-pad",
+    .policy = core::ThreadOptions::Policy::realTime,
+    .priority = 40};
+
+// The device replies within a few ms, the longest being the ~50 ms of a scene
+// upload. No reply comes if the message didn't reach it.
+constexpr auto replyTimeout = std::chrono::seconds{2};
+
 struct GlobalDataDumpRequest
 {
     static constexpr auto& hostMessage = sysex::globalDataDumpReq;
@@ -235,17 +253,16 @@ using CommandReply =
                  NativeModeRequest<false>, PacketCommunicationCmd,
                  ResetDefaultScene, SetCurrentScene>;
 
-std::error_code check(std::future<Expected<bool>>&& future)
+std::error_code check(const Expected<bool>& result)
 {
-    auto result = future.get();
     if (!result)
         return result.error();
     if (!*result)
         return KorgPadKontrol::Error::packetCommunicationError;
     return std::error_code{};
 }
-#define POST_AND_CHECK(cmd)                    \
-    if (auto error = check(_postCommand(cmd))) \
+#define POST_AND_CHECK(cmd)                                   \
+    if (auto error = check(_waitForReply(_postCommand(cmd)))) \
         return error;
 
 } // namespace
@@ -267,13 +284,20 @@ class KorgPadKontrol::_Impl
 public:
     _Impl(Engine* engine, ClientInfo&& deviceInfo, std::string&& midiClientName)
         : _engine{engine}
+        , _shard{engine->addShard(threadOptions)}
         , _deviceInfo{std::move(deviceInfo)}
         , _midiClientName{std::move(midiClientName)}
         , _mode{Mode::native}
+        , _program{std::make_unique<const korgPadKontrol::Program>()}
     {
     }
 
-    ~_Impl() { _stopPolling(); }
+    ~_Impl()
+    {
+        _stopPolling();
+        _releaseNotes();
+        _engine->removeShard(_shard);
+    }
 
     ClientId deviceId() const { return _deviceInfo.id; }
 
@@ -283,8 +307,11 @@ public:
     {
         if (_mode == mode && _client)
             return std::error_code{};
+        if (mode == Mode::normal && !_clientReadsDevice())
+            return Error::unsupportedMode;
 
         _stopPolling();
+        _releaseNotes();
 
         // The connections must be closed before proceeding.
         _device = std::nullopt;
@@ -297,14 +324,31 @@ public:
         if (!device)
             return device.error();
 
-        auto client = _engine->open(
-            _midiClientName,
-            mode == Mode::native ? PortDirection::read : PortDirection::duplex);
+        // The input takes the clock for the tempo in both modes, a clock
+        // source can be connected to it.
+        auto client = _engine->open(_midiClientName, PortDirection::duplex);
         if (!client)
         {
             return client.error();
         }
 
+        // In normal mode the system exclusive messages are kept for the
+        // device replies. In native mode the device is read through raw
+        // MIDI and the input is only for the clock.
+        const auto filter =
+            mode == Mode::native
+                ? EventFilter::none()
+                      .accept<events::Clock, events::Start, events::Continue,
+                              events::Stop, events::SongPosition>()
+                : EventFilter{}
+                      .reject<events::ActiveSensing, events::Echo,
+                              events::Bounce, events::None, events::Unknown,
+                              events::System, events::Result>();
+        if (auto error = client->setEventFilter(filter);
+            error != std::error_code{})
+        {
+            return error;
+        }
         if (mode == Mode::normal)
         {
             if (auto error = client->connectInput(_deviceInfo, 1);
@@ -316,6 +360,8 @@ public:
 
         _device = std::move(*device);
         _client = std::move(*client);
+        // The scene in the device is unknown after a mode change.
+        _uploadedPayload = std::nullopt;
 
         _startPolling();
 
@@ -339,22 +385,39 @@ public:
         return _handShake();
     }
 
-    std::error_code setProgram(korgPadKontrol::Program program)
+    std::error_code setProgram(korgPadKontrol::Program program,
+                               bool forceUpload)
     {
-        {
-            std::lock_guard<std::mutex> lock(_programMutex);
-            _program = std::move(program);
-        }
+        // The scene is encoded before publishing the program because the
+        // published object may be reclaimed by a concurrent setProgram.
+        std::optional<Expected<std::array<std::byte, 138>>> payload;
+        if (const auto* scene = program.scene())
+            payload = encodeScene(*scene);
+
+        // Readers in the poll thread keep using the previous program until
+        // they are done with the event at hand, they are never blocked.
+        _program.publish(std::make_unique<const korgPadKontrol::Program>(
+            std::move(program)));
+        // The notes on may be translated differently by the new program,
+        // the poll thread releases them right away, or before the next event
+        // if one comes first.
+        _notesReleasePending.store(true, std::memory_order_release);
+        _engine->post([this] { _releasePendingNotes(); }, _shard);
 
-        auto scene = _program.scene();
-        if (!scene)
+        if (!payload)
             return ProgramError::invalidProgram;
+        if (!*payload)
+            return payload->error();
 
-        auto payload = encodeScene(*scene);
-        if (!payload)
-            return payload.error();
+        // The device only accepts full scene dumps, which take ~50 ms to
+        // transfer, so the upload is skipped if the device already has the
+        // same scene.
+        if (!forceUpload && _uploadedPayload == **payload)
+            return std::error_code{};
 
-        POST_AND_CHECK(SetCurrentScene(*payload));
+        _uploadedPayload = std::nullopt;
+        POST_AND_CHECK(SetCurrentScene(**payload));
+        _uploadedPayload = **payload;
 
         return std::error_code{};
     }
@@ -418,11 +481,56 @@ public:
         //    }
         // }
         // printf("\n");
-        return _postCommand(CurrentSceneDataDumpRequest{}).get();
+        auto scene = _waitForReply(_postCommand(CurrentSceneDataDumpRequest{}));
+        if (scene)
+        {
+            auto payload = encodeScene(*scene);
+            if (payload)
+                _uploadedPayload = *payload;
+        }
+        return scene;
+    }
+
+    const std::vector<std::byte>& identity() const { return _identity; }
+
+    std::error_code setKnownScene(const Scene& scene)
+    {
+        const auto payload = encodeScene(scene);
+        if (!payload)
+            return payload.error();
+        _uploadedPayload = *payload;
+        return std::error_code{};
+    }
+
+    std::optional<Scene> knownScene() const
+    {
+        if (!_uploadedPayload)
+            return std::nullopt;
+        auto scene = korgPadKontrol::decodeScene(*_uploadedPayload);
+        if (!scene)
+            return std::nullopt;
+        return std::move(*scene);
+    }
+
+    void setTap(Tap tap)
+    {
+        _tap.publish(std::make_unique<const Tap>(std::move(tap)));
+    }
+
+    TempoTracker::State tempo() { return _tempo.state(); }
+
+    /// The mode the controller is opened in, the normal mode reads the
+    /// device through the client.
+    Mode initialMode() const
+    {
+        return _clientReadsDevice() ? Mode::normal : Mode::native;
     }
 
 private:
     Engine* _engine{nullptr};
+    // The device and client inputs share the state of the controller, they
+    // are polled from the same thread, which no other controller uses.
+    Engine::Shard _shard;
     ClientInfo _deviceInfo;
     std::string _midiClientName;
     Mode _mode;
@@ -435,26 +543,41 @@ private:
     std::mutex _pendingReplyMutex;
     std::vector<CommandReply> _pendingReplies;
 
-    std::mutex _programMutex;
-    korgPadKontrol::Program _program;
+    RcuPointer<korgPadKontrol::Program> _program;
+    RcuPointer<Tap> _tap;
+    // Fed from the poll thread
+    TempoTracker _tempo;
+    std::atomic<bool> _notesReleasePending{false};
+
+    /// The last scene known to be in the device
+    std::optional<std::array<std::byte, 138>> _uploadedPayload;
+    std::vector<std::byte> _identity;
 
     void _processDeviceEvents()
     {
         assert(_mode == Mode::native);
+        _releasePendingNotes();
+        const auto tap = _tap.read();
         _tokenizer.processInput(
-            [this](std::span<const std::byte> payload) {
-                _decodeMessage(payload);
+            [this, &tap](std::span<const std::byte> payload) {
+                if (tap && tap->deviceInput)
+                    tap->deviceInput(payload);
+                _decodeMessage(payload, tap.get());
             },
-            [this]() { _cancelPendingCommands(); });
+            [this]() { _cancelPendingCommands(DeviceError::streamReadError); });
+        if (tap && tap->deviceInputProcessed)
+            tap->deviceInputProcessed();
     }
 
-    void _decodeMessage(std::span<const std::byte> payload)
+    void _decodeMessage(std::span<const std::byte> payload, const Tap* tap)
     {
         auto event = korgPadKontrol::decodeEvent(payload);
         if (event)
         {
-            std::lock_guard<std::mutex> lock(_programMutex);
-            _program.processEvent(*event, *_client, *_device);
+            if (tap && tap->deviceEvent)
+                tap->deviceEvent(*event);
+            _program.read()->processEvent(*event, *_client, *_device,
+                                          _outputObserver(tap));
         }
 
         std::lock_guard<std::mutex> lock(_pendingReplyMutex);
@@ -472,6 +595,7 @@ private:
 
     void _processClientEvents()
     {
+        _releasePendingNotes();
         while (_client->hasEvents())
         {
             const auto event = _client->readEvent();
@@ -481,17 +605,55 @@ private:
                 return;
             }
 
+            const auto tap = _tap.read();
+            if (tap && tap->clientInput)
+                tap->clientInput(*event);
+
+            // The clock events are still forwarded by the program.
+            _tempo.process(*event);
+
             std::visit( //
-                overloaded{[this](auto&& event) {
-                               _program.processEvent(event, *_client);
+                overloaded{[this, &tap](auto&& event) {
+                               _program.read()->processEvent(
+                                   event, *_client, _outputObserver(tap.get()));
                            },
-                           [this](const events::SysEx& event) {
+                           [this, &tap](const events::SysEx& event) {
                                _decodeMessage(std::span<const std::byte>{
-                                   event.data.begin() + 1,
-                                   event.data.end() - 1});
+                                                  event.data.begin() + 1,
+                                                  event.data.end() - 1},
+                                              tap.get());
                            }},
                 *event);
         }
+
+        const auto tap = _tap.read();
+        if (tap && tap->deviceInputProcessed)
+            tap->deviceInputProcessed();
+    }
+
+    void _releasePendingNotes()
+    {
+        if (_notesReleasePending.load(std::memory_order_relaxed) &&
+            _notesReleasePending.exchange(false, std::memory_order_acquire))
+        {
+            _releaseNotes();
+        }
+    }
+
+    /// Only from the poll thread or while not polling.
+    void _releaseNotes()
+    {
+        if (!_client)
+            return;
+        const auto tap = _tap.read();
+        if (auto error = _client->releaseNotes(_outputObserver(tap.get())))
+            core::log() << error.message();
+    }
+
+    static const korgPadKontrol::Program::OutputObserver* _outputObserver(
+        const Tap* tap)
+    {
+        return tap && tap->clientOutput ? &tap->clientOutput : nullptr;
     }
 
     void _startPolling()
@@ -505,7 +667,7 @@ private:
             };
             if (auto handle = _device->pollHandle(PollEvents::in))
             {
-                _engine->add(handle, callback);
+                _engine->add(handle, callback, _shard);
             }
         }
         if (_client)
@@ -515,7 +677,7 @@ private:
             };
             if (auto handle = _client->pollHandle(PollEvents::in))
             {
-                _engine->add(handle, callback);
+                _engine->add(handle, callback, _shard);
             }
         }
     }
@@ -530,19 +692,32 @@ private:
         {
             _engine->remove(_client->pollHandle(PollEvents::in)).wait();
         }
+
+        // The tasks posted use the client too, they run in order, so the
+        // ones already posted are done when this one is.
+        std::promise<void> done;
+        auto future = done.get_future();
+        _engine->post([&done] { done.set_value(); }, _shard);
+        future.wait();
     }
 
-    std::error_code _handShake()
+    /// JACK clients don't transport SysEx messages and can't connect to the
+    /// ALSA ports of the device, its replies are only read through raw MIDI.
+    bool _clientReadsDevice() const
     {
-        auto reply = _postCommand(IdentityRequest{});
+        return _engine->backend() == EngineBackend::alsa;
+    }
 
-        auto message = reply.get();
+    std::error_code _handShake()
+    {
+        auto message = _waitForReply(_postCommand(IdentityRequest{}));
         if (!message)
             return message.error();
 
         if ((*message)[4] != sysex::KORG || (*message)[5] != sysex::SW_PROJECT)
             return Error::unrecognizedDevice;
 
+        _identity = std::move(*message);
         return std::error_code{};
     }
 
@@ -570,16 +745,25 @@ private:
         return future;
     }
 
-    void _cancelPendingCommands()
+    /// The commands are sent one at a time, so the ones pending when the
+    /// reply doesn't come are cancelled.
+    template <typename Reply>
+    Reply _waitForReply(std::future<Reply>&& future)
+    {
+        if (future.wait_for(replyTimeout) != std::future_status::ready)
+            _cancelPendingCommands(std::make_error_code(std::errc::timed_out));
+        return future.get();
+    }
+
+    void _cancelPendingCommands(std::error_code error)
     {
         std::lock_guard<std::mutex> lock(_pendingReplyMutex);
         // Cancel all pending commands
         for (auto& command : _pendingReplies)
         {
             std::visit(
-                [](auto&& command) {
-                    command.promise.set_value(
-                        tl::make_unexpected(DeviceError::streamReadError));
+                [error](auto&& command) {
+                    command.promise.set_value(tl::make_unexpected(error));
                 },
                 command);
         }
@@ -593,7 +777,8 @@ Expected<KorgPadKontrol> KorgPadKontrol::open(Engine* engine,
 {
     auto impl = std::make_unique<_Impl>(engine, std::move(deviceInfo),
                                         std::move(midiClientName));
-    if (auto error = impl->setMode(Mode::normal); error != std::error_code{})
+    const auto mode = impl->initialMode();
+    if (auto error = impl->setMode(mode); error != std::error_code{})
         return tl::unexpected(error);
 
     return KorgPadKontrol(std::move(impl));
@@ -625,9 +810,10 @@ std::error_code KorgPadKontrol::setMode(Mode mode)
     return _impl->setMode(mode);
 }
 
-std::error_code KorgPadKontrol::setProgram(korgPadKontrol::Program program)
+std::error_code KorgPadKontrol::setProgram(korgPadKontrol::Program program,
+                                           bool forceUpload)
 {
-    return _impl->setProgram(std::move(program));
+    return _impl->setProgram(std::move(program), forceUpload);
 }
 
 std::future<Expected<bool>> KorgPadKontrol::sendNativeCommand(
@@ -641,4 +827,30 @@ Expected<korgPadKontrol::Scene> KorgPadKontrol::queryCurrentScene()
     return _impl->queryCurrentScene();
 }
 
+const std::vector<std::byte>& KorgPadKontrol::identity() const
+{
+    return _impl->identity();
+}
+
+std::error_code KorgPadKontrol::setKnownScene(
+    const korgPadKontrol::Scene& scene)
+{
+    return _impl->setKnownScene(scene);
+}
+
+std::optional<korgPadKontrol::Scene> KorgPadKontrol::knownScene() const
+{
+    return _impl->knownScene();
+}
+
+void KorgPadKontrol::setTap(Tap tap)
+{
+    _impl->setTap(std::move(tap));
+}
+
+TempoTracker::State KorgPadKontrol::tempo()
+{
+    return _impl->tempo();
+}
+
 } // namespace paddock::midi
@@ -2,10 +2,18 @@
 
 #include "korgPadKontrol/nativeEvents.hpp"
 
+#include "midi/TempoTracker.hpp"
+#include "midi/events.hpp"
+
 #include <utils/Expected.hpp>
 
+#include <cstddef>
+#include <functional>
 #include <future>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace paddock::midi
 {
@@ -26,7 +34,8 @@ public:
     enum class Error
     {
         unrecognizedDevice = 1,
-        packetCommunicationError
+        packetCommunicationError,
+        unsupportedMode
     };
 
     enum class Mode
@@ -35,8 +44,27 @@ public:
         normal
     };
 
+    /// Observes the input traffic, e.g. to capture it. The callbacks are
+    /// called from the poll thread before the events are processed.
+    struct Tap
+    {
+        /// SysEx payloads read from the device in native mode, without the
+        /// start and end bytes.
+        std::function<void(std::span<const std::byte>)> deviceInput;
+        /// The events decoded from the device SysEx messages.
+        std::function<void(const korgPadKontrol::Event&)> deviceEvent;
+        /// Called after each batch of input has been processed, e.g. to
+        /// flush what the other callbacks buffered.
+        std::function<void()> deviceInputProcessed;
+        std::function<void(const events::Event&)> clientInput;
+        /// The events posted by the program, after the mapping.
+        std::function<void(const events::Event&)> clientOutput;
+    };
+
     static bool matches(const ClientInfo& client);
 
+    /// The controller is opened in normal mode, or in native mode if the
+    /// engine clients can't read the device, e.g. with JACK.
     static Expected<KorgPadKontrol> open(Engine* engine, ClientInfo device,
                                          std::string midiClientName);
 
@@ -50,10 +78,16 @@ public:
 
     ClientId deviceId() const;
 
+    /// The normal mode is unsupported if the engine clients can't read the
+    /// device. The commands fail with std::errc::timed_out if the device
+    /// doesn't reply.
     std::error_code setMode(Mode mode);
     Mode mode() const;
 
-    std::error_code setProgram(korgPadKontrol::Program program);
+    /// The scene is only uploaded if it differs from the last one uploaded to
+    /// or queried from the device, unless forceUpload is true.
+    std::error_code setProgram(korgPadKontrol::Program program,
+                               bool forceUpload = false);
 
     // We need future.then to return std::future<std::error_code> without
     // complicatint the implementation.
@@ -62,6 +96,27 @@ public:
 
     Expected<korgPadKontrol::Scene> queryCurrentScene();
 
+    /// The identity reply received in the last handshake, which tells the
+    /// device model and firmware version.
+    const std::vector<std::byte>& identity() const;
+
+    /// Declares the scene in the device without querying it, e.g. a scene
+    /// cached when the same device was last connected. setProgram won't
+    /// upload it again.
+    std::error_code setKnownScene(const korgPadKontrol::Scene& scene);
+
+    /// The last scene uploaded to, queried from or declared for the device
+    /// since the last mode change.
+    std::optional<korgPadKontrol::Scene> knownScene() const;
+
+    /// Can be replaced while polling, an empty tap removes it.
+    void setTap(Tap tap);
+
+    /// The tempo of the MIDI clock received by the client input in either
+    /// mode, if any, e.g. from a sequencer connected to it. Must be called
+    /// from one thread at a time, e.g. the MIDI thread.
+    TempoTracker::State tempo();
+
 private:
     class _Impl;
     // A shared ptr is needed to capture it in the callbacks passed
@@ -75,6 +130,8 @@ private:
     void _clientInEvent();
 };
 
+std::error_code make_error_code(KorgPadKontrol::Error error);
+
 } // namespace paddock::midi
 
 #include <system_error>
@@ -0,0 +1,67 @@
+#include "PadSet.hpp"
+
+#include "midi/Client.hpp"
+#include "midi/Engine.hpp"
+
+#include <algorithm>
+
+namespace paddock::midi
+{
+ClientId deviceId(const Pad& pad)
+{
+    return std::visit([](const auto& pad) { return pad.deviceId(); }, pad);
+}
+
+PadSet::PadSet(Engine* engine, std::string midiClientName)
+    : _engine{engine}
+    , _midiClientName{std::move(midiClientName)}
+{
+}
+
+std::vector<Expected<Pad*>> PadSet::connectAll()
+{
+    std::vector<Expected<Pad*>> results;
+    for (const auto& deviceInfo : _engine->queryClientInfos())
+    {
+        if (!KorgPadKontrol::matches(deviceInfo) || find(deviceInfo.id))
+            continue;
+        results.push_back(connect(deviceInfo));
+    }
+    return results;
+}
+
+Expected<Pad*> PadSet::connect(const ClientInfo& deviceInfo)
+{
+    if (auto* pad = find(deviceInfo.id))
+        return pad;
+
+    return _engine->connect(_midiClientName, deviceInfo)
+        .map([this](Pad&& pad) {
+            _pads.push_back(std::move(pad));
+            return &_pads.back();
+        });
+}
+
+bool PadSet::disconnect(const ClientId& client)
+{
+    const auto pad =
+        std::find_if(_pads.begin(), _pads.end(), [&client](const Pad& pad) {
+            return deviceId(pad) == client;
+        });
+    if (pad == _pads.end())
+        return false;
+    _pads.erase(pad);
+    return true;
+}
+
+Pad* PadSet::find(const ClientId& client)
+{
+    for (auto& pad : _pads)
+    {
+        if (deviceId(pad) == client)
+            return &pad;
+    }
+    return nullptr;
+}
+
+} // namespace paddock::midi
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "pads.hpp"
+
+#include "midi/types.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace paddock::midi
+{
+class ClientInfo;
+class Engine;
+
+/// The controllers of a rig, all driven by the same engine.
+///
+/// Each controller has its own device connection, sysex tokenizer, pending
+/// replies and program, and they are all dispatched by the engine pollers.
+/// Each controller is polled from a real-time thread of its own, so its
+/// events never wait for the other controllers.
+class PadSet
+{
+public:
+    PadSet(Engine* engine, std::string midiClientName);
+
+    PadSet(PadSet&& other) noexcept = default;
+    PadSet& operator=(PadSet&& other) noexcept = default;
+
+    PadSet(const PadSet& other) = delete;
+    PadSet& operator=(const PadSet& other) = delete;
+
+    /// Opens the recognized controllers that aren't in the set yet.
+    /// @return the result for each controller found, successful or not
+    std::vector<Expected<Pad*>> connectAll();
+
+    /// Opens the controller of a client unless it's already in the set.
+    /// @return EngineError::noDeviceFound if the client is not a recognized
+    /// controller
+    Expected<Pad*> connect(const ClientInfo& deviceInfo);
+
+    /// Closes the controller of a client.
+    /// @return true if the client was in the set
+    bool disconnect(const ClientId& client);
+
+    /// @return nullptr if the client is not in the set
+    Pad* find(const ClientId& client);
+
+    bool empty() const { return _pads.empty(); }
+    size_t size() const { return _pads.size(); }
+
+    // The pointers returned are stable until the controller is disconnected.
+    auto begin() { return _pads.begin(); }
+    auto end() { return _pads.end(); }
+
+private:
+    Engine* _engine;
+    std::string _midiClientName;
+    std::list<Pad> _pads;
+};
+
+/// @return the client of the device to which a controller is connected
+ClientId deviceId(const Pad& pad);
+
+} // namespace paddock::midi
@@ -1,15 +1,135 @@
 #include "Program.hpp"
 
 #include "midi/Client.hpp"
-#include "midi/eventPrinters.hpp"
-#include "nativeEventPrinters.hpp"
 
-#include <iostream>
+#include "utils/overloaded.hpp"
+
+#include <bitset>
 
 namespace paddock::midi
 {
 namespace korgPadKontrol
 {
+namespace
+{
+std::optional<Value7bit> channelOf(const Scene::Trigger& trigger)
+{
+    if (!trigger.enabled || trigger.midiChannel < 1 || trigger.midiChannel > 16)
+        return std::nullopt;
+    return Value7bit(trigger.midiChannel - 1);
+}
+
+template <typename F>
+void translateTrigger(const Scene::Trigger& trigger, bool on,
+                      Value7bit velocity, F& emit)
+{
+    const auto channel = channelOf(trigger);
+    if (!channel)
+        return;
+
+    std::visit(
+        overloaded{[&](const Scene::Note& note) {
+                       if (!on)
+                       {
+                           emit(midi::events::NoteOff{*channel, note.note, 0});
+                           return;
+                       }
+                       // The device applies the velocity curves itself.
+                       if (const auto fixed =
+                               std::get_if<Value7bit>(&note.velocity))
+                       {
+                           velocity = *fixed;
+                       }
+                       emit(midi::events::NoteOn{*channel, note.note,
+                                                 velocity});
+                   },
+                   [&](const Scene::Control& control) {
+                       emit(midi::events::Controller{
+                           *channel, on ? control.value : control.releaseValue,
+                           control.param});
+                   }},
+        trigger.action);
+}
+
+template <typename F>
+void translateKnob(const Scene& scene, const Scene::Knob& knob,
+                   Value7bit value, F& emit)
+{
+    if (!knob.enabled)
+        return;
+    if (knob.reversePolarity)
+        value = 127 - value;
+
+    // One event per channel, no matter how many triggers share it.
+    std::bitset<16> channels;
+    for (size_t i = 0; i != scene.pads.size(); ++i)
+    {
+        const auto channel = channelOf(scene.pads[i]);
+        if (channel && (knob.padAssignmentBits >> i & 1) != 0)
+            channels.set(*channel);
+    }
+    if (const auto channel = channelOf(scene.pedal);
+        channel && knob.pedalAssigned)
+    {
+        channels.set(*channel);
+    }
+
+    for (Value7bit channel = 0; channel != channels.size(); ++channel)
+    {
+        if (!channels.test(channel))
+            continue;
+        switch (knob.type)
+        {
+        case Scene::KnobType::PitchBend:
+        {
+            // 0 maps to -8192, 64 to the center and 127 to 8191.
+            const int offset = value - 64;
+            emit(midi::events::PitchBend{
+                channel,
+                Value14bit(offset < 0 ? offset * 128 : offset * 8191 / 63)});
+            break;
+        }
+        case Scene::KnobType::AfterTouch:
+            emit(midi::events::ChannelPressure{channel, value});
+            break;
+        case Scene::KnobType::Controller:
+            emit(midi::events::Controller{channel, value, knob.param});
+            break;
+        }
+    }
+}
+
+template <typename F>
+void translateEvent(const Scene& scene, const Event& event, F& emit)
+{
+    using namespace events;
+    std::visit(overloaded{[&](const PadOutput& event) {
+                              if (event.number >= 0 &&
+                                  size_t(event.number) < scene.pads.size())
+                              {
+                                  translateTrigger(scene.pads[event.number],
+                                                   event.on, event.velocity,
+                                                   emit);
+                              }
+                          },
+                          [&](const PedalOutput& event) {
+                              translateTrigger(scene.pedal, event.data != 0,
+                                               127, emit);
+                          },
+                          [&](const KnobOutput& event) {
+                              translateKnob(scene,
+                                            scene.knobs[size_t(event.knob)],
+                                            event.value, emit);
+                          },
+                          [&](const XyOutput& event) {
+                              translateKnob(scene, scene.x, event.x, emit);
+                              translateKnob(scene, scene.y, event.y, emit);
+                          },
+                          [](const auto&) {}},
+               event);
+}
+} // namespace
+
 void Program::setScene(Scene scene)
 {
     _scene = std::move(scene);
@@ -20,17 +140,44 @@ const Scene* Program::scene() const
     return _scene ? &*_scene : nullptr;
 }
 
-void Program::processEvent(const Event& event, Client& client, Device& device)
+void Program::setMapping(Mapping mapping)
+{
+    _mapping = std::move(mapping);
+}
+
+const Mapping& Program::mapping() const
+{
+    return _mapping;
+}
+
+void Program::processEvent(const Event& event, Client& client, Device& device,
+                           const OutputObserver* observer) const
 {
-    std::cout << event << std::endl;
-    (void)client;
     (void)device;
+
+    if (!_scene)
+        return;
+
+    auto post = [this, &client, observer](const midi::events::Event& event) {
+        _mapping.apply(event, [&client, observer](
+                                  const midi::events::Event& event) {
+            client.postEvent(event);
+            if (observer)
+                (*observer)(event);
+        });
+    };
+    translateEvent(*_scene, event, post);
 }
 
-void Program::processEvent(const midi::events::Event& event, Client& client)
+void Program::processEvent(const midi::events::Event& event, Client& client,
+                           const OutputObserver* observer) const
 {
-    std::cout << event << std::endl;
-    client.postEvent(event);
+    _mapping.apply(event,
+                   [&client, observer](const midi::events::Event& event) {
+                       client.postEvent(event);
+                       if (observer)
+                           (*observer)(event);
+                   });
 }
 
 } // namespace korgPadKontrol
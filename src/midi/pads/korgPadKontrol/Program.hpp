@@ -3,6 +3,7 @@
 #include "Scene.hpp"
 #include "nativeEvents.hpp"
 
+#include "midi/Mapping.hpp"
 #include "midi/events.hpp"
 
 #include <functional>
@@ -21,16 +22,32 @@ public:
     using EventNotifier = std::function<void(const Event&)>;
     EventNotifier eventNotifier;
 
+    /// Sees the events posted to the client, e.g. to record them.
+    using OutputObserver = std::function<void(const midi::events::Event&)>;
+
     void setScene(Scene scene);
     /// Returns nullptr if no scene has been set yet
     const Scene* scene() const;
 
-    void processEvent(const Event& event, Client& client, Device& device);
+    /// Applied to the MIDI events posted in both modes.
+    void setMapping(Mapping mapping);
+    const Mapping& mapping() const;
+
+    /// The program is immutable while processing events, so it can be
+    /// shared with the thread that edits and replaces it.
+    ///
+    /// In native mode the events are translated to MIDI as the device would
+    /// do with the scene. Toggle triggers behave as momentary ones because
+    /// their state isn't tracked.
+    void processEvent(const Event& event, Client& client, Device& device,
+                      const OutputObserver* observer = nullptr) const;
 
-    void processEvent(const midi::events::Event& event, Client& client);
+    void processEvent(const midi::events::Event& event, Client& client,
+                      const OutputObserver* observer = nullptr) const;
 
 private:
     std::optional<Scene> _scene;
+    Mapping _mapping;
 };
 
 } // namespace korgPadKontrol
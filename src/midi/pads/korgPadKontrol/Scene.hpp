@@ -5,6 +5,7 @@
 #include "utils/Expected.hpp"
 #include "utils/byte.hpp"
 
+#include <bitset>
 #include <optional>
 #include <span>
 #include <variant>
@@ -108,10 +109,68 @@ struct Scene
     Value7bit fixedVelocity;
 };
 
+/// Identifies a field of a scene, e.g. to track what has changed.
+enum class SceneSection : unsigned char
+{
+    pad,
+    pedal,
+    knob,
+    axis, // index 0 for x, 1 for y
+    repeater, // index 0 for flam, 1 for roll
+    fixedVelocity
+};
+
+enum class SceneField : unsigned char
+{
+    // Triggers
+    enabled,
+    midiChannel,
+    switchType,
+    port,
+    flamRoll,
+    action,
+    // Knobs and axes
+    knobType, // Includes enabled
+    polarity,
+    parameter,
+    padAssignment,
+    pedalAssignment,
+    releaseValue,
+    // Repeaters
+    minSpeed,
+    maxSpeed,
+    minVolume,
+    maxVolume,
+    // Fixed velocity
+    value
+};
+
+struct ScenePath
+{
+    SceneSection section;
+    unsigned char index;
+    SceneField field;
+
+    bool operator==(const ScenePath& other) const = default;
+};
+
+constexpr size_t sceneFieldCount = 133;
+
+/// Bit i is set if the field sceneFieldPaths()[i] differs.
+using SceneDiff = std::bitset<sceneFieldCount>;
+
 Expected<std::array<std::byte, 138>> encodeScene(const Scene& scene);
 Expected<Scene> decodeScene(std::span<const std::byte> payload);
 
+/// @return std::errc::invalid_argument if any value is out of range
+std::error_code validateScene(const Scene& scene);
+
+SceneDiff diffScenes(const Scene& lhs, const Scene& rhs);
+const std::array<ScenePath, sceneFieldCount>& sceneFieldPaths();
+
 bool operator==(const Scene& lhs, const Scene& rhs);
+bool operator==(const Scene::Note& lhs, const Scene::Note& rhs);
+bool operator==(const Scene::Control& lhs, const Scene::Control& rhs);
 bool operator==(const Scene::Trigger& lhs, const Scene::Trigger& rhs);
 bool operator==(const Scene::Knob& lhs, const Scene::Knob& rhs);
 bool operator==(const Scene::Axis& lhs, const Scene::Axis& rhs);
@@ -0,0 +1,438 @@
+#pragma once
+
+#include "Scene.hpp"
+
+#include "midi/layout.hpp"
+
+#include "utils/mp.hpp"
+
+#include <optional>
+
+/// Layout of the 138 byte scene payload of the current scene dump.
+namespace paddock::midi::korgPadKontrol::sceneLayout
+{
+using layout::Bit;
+
+struct TriggerLayout
+{
+    int channel; // bit 4: enabled, bit 5: switch type, bits 0-3: channel
+    Bit port;
+    Bit flamRoll;
+    Bit actionType;
+    int id;
+    int value;
+    int releaseValue;
+    int velocity;
+    std::optional<Bit> velocityType; // The pedal has always fixed velocity
+};
+
+// Pads 1-16 and pedal
+constexpr TriggerLayout triggers[] = {
+    {1, {131, 0}, {99, 0}, {16, 2}, 19, 74, 55, 37, Bit{32, 4}},
+    {2, {131, 1}, {99, 1}, {16, 3}, 20, 75, 57, 38, Bit{32, 5}},
+    {3, {131, 2}, {99, 2}, {16, 4}, 21, 76, 58, 39, Bit{32, 6}},
+    {4, {131, 3}, {99, 3}, {16, 5}, 22, 77, 59, 41, Bit{40, 0}},
+    {5, {131, 4}, {99, 4}, {16, 6}, 23, 78, 60, 42, Bit{40, 1}},
+    {6, {131, 5}, {99, 5}, {24, 0}, 25, 79, 61, 43, Bit{40, 2}},
+    {7, {131, 6}, {99, 6}, {24, 1}, 26, 81, 62, 44, Bit{40, 3}},
+    {9, {128, 2}, {96, 2}, {24, 2}, 27, 82, 63, 45, Bit{40, 4}},
+    {10, {132, 0}, {100, 0}, {24, 3}, 28, 83, 65, 46, Bit{40, 5}},
+    {11, {132, 1}, {100, 1}, {24, 4}, 29, 84, 66, 47, Bit{40, 6}},
+    {12, {132, 2}, {100, 2}, {24, 5}, 30, 85, 67, 49, Bit{48, 0}},
+    {13, {132, 3}, {100, 3}, {24, 6}, 31, 86, 68, 50, Bit{48, 1}},
+    {14, {132, 4}, {100, 4}, {32, 0}, 33, 87, 69, 51, Bit{48, 2}},
+    {15, {132, 5}, {100, 5}, {32, 1}, 34, 89, 70, 52, Bit{48, 3}},
+    {17, {132, 6}, {100, 6}, {32, 2}, 35, 90, 71, 53, Bit{48, 4}},
+    {18, {128, 3}, {96, 3}, {32, 3}, 36, 91, 73, 54, Bit{48, 5}},
+    {93, {133, 1}, {93, 6}, {88, 5}, 94, 98, 97, 95, std::nullopt}};
+
+struct KnobLayout
+{
+    int type; // bits 4-7: type, bit 1: polarity, bit 0: pedal assignment
+    int param;
+    std::array<Bit, 16> pads;
+};
+
+// Knobs 1-2, x and y axes
+constexpr KnobLayout knobs[] = {
+    {101,
+     102,
+     {{{103, 0}, {103, 1}, {103, 2}, {103, 3}, {103, 4}, {103, 5}, {103, 6},
+       {96, 6}, {105, 0}, {105, 1}, {105, 2}, {105, 3}, {105, 4}, {105, 5},
+       {105, 6}, {104, 0}}}},
+    {106,
+     107,
+     {{{108, 0}, {108, 1}, {108, 2}, {108, 3}, {108, 4}, {108, 5}, {108, 6},
+       {104, 3}, {109, 0}, {109, 1}, {109, 2}, {109, 3}, {109, 4}, {109, 5},
+       {109, 6}, {104, 4}}}},
+    {110,
+     111,
+     {{{113, 0}, {113, 1}, {113, 2}, {113, 3}, {113, 4}, {113, 5}, {113, 6},
+       {112, 0}, {114, 0}, {114, 1}, {114, 2}, {114, 3}, {114, 4}, {114, 5},
+       {114, 6}, {112, 1}}}},
+    {116,
+     117,
+     {{{118, 0}, {118, 1}, {118, 2}, {118, 3}, {118, 4}, {118, 5}, {118, 6},
+       {112, 5}, {119, 0}, {119, 1}, {119, 2}, {119, 3}, {119, 4}, {119, 5},
+       {119, 6}, {112, 6}}}}};
+
+struct AxisLayout
+{
+    int releaseValue;
+    Bit releaseValueSign;
+};
+
+constexpr AxisLayout axes[] = {{115, {112, 2}}, {121, {120, 0}}};
+
+struct RepeaterLayout
+{
+    int minSpeed;
+    Bit minSpeedHigh;
+    int maxSpeed;
+    Bit maxSpeedHigh;
+    int minVolume;
+    int maxVolume;
+};
+
+// Flam and roll
+constexpr RepeaterLayout repeaters[] = {
+    {124, {120, 3}, 125, {120, 4}, 126, 127},
+    {122, {120, 1}, 123, {120, 2}, 129, 130}};
+
+constexpr int fixedVelocity = 92;
+
+// Field access
+
+template <size_t index>
+struct TriggerAccess
+{
+    template <typename SceneT>
+    static auto& get(SceneT& scene)
+    {
+        if constexpr (index < 16)
+            return scene.pads[index];
+        else
+            return scene.pedal;
+    }
+};
+
+// Indices 0-1 for knobs, 2-3 for axes
+template <size_t index>
+struct KnobAccess
+{
+    template <typename SceneT>
+    static auto& get(SceneT& scene)
+    {
+        if constexpr (index < 2)
+            return scene.knobs[index];
+        else if constexpr (index == 2)
+            return scene.x;
+        else
+            return scene.y;
+    }
+};
+
+template <size_t index>
+struct RepeaterAccess
+{
+    template <typename SceneT>
+    static auto& get(SceneT& scene)
+    {
+        if constexpr (index == 0)
+            return scene.flam;
+        else
+            return scene.roll;
+    }
+};
+
+struct SceneAccess
+{
+    template <typename SceneT>
+    static auto& get(SceneT& scene)
+    {
+        return scene;
+    }
+};
+
+constexpr ScenePath triggerPath(size_t index, SceneField field)
+{
+    if (index < 16)
+        return {SceneSection::pad, static_cast<unsigned char>(index), field};
+    return {SceneSection::pedal, 0, field};
+}
+
+constexpr ScenePath knobPath(size_t index, SceneField field)
+{
+    if (index < 2)
+        return {SceneSection::knob, static_cast<unsigned char>(index), field};
+    return {SceneSection::axis, static_cast<unsigned char>(index - 2), field};
+}
+
+constexpr ScenePath repeaterPath(size_t index, SceneField field)
+{
+    return {SceneSection::repeater, static_cast<unsigned char>(index), field};
+}
+
+// Fields that don't fit in the generic ones
+
+template <size_t index>
+struct TriggerChannel
+    : layout::Member<triggerPath(index, SceneField::midiChannel),
+                     TriggerAccess<index>, &Scene::Trigger::midiChannel>
+{
+    using Access = TriggerAccess<index>;
+    static constexpr auto byte = triggers[index].channel;
+
+    static void encode(const Scene& scene, std::span<std::byte> payload)
+    {
+        const auto& trigger = Access::get(scene);
+        // Channel 0 (what disabled triggers decode to) is sent as channel 1
+        const auto channel = trigger.midiChannel - (trigger.midiChannel != 0);
+        payload[byte] |= std::byte(channel & 0x0F & -int(trigger.enabled));
+    }
+
+    // Requires the enabled bit to be decoded first.
+    static void decode(std::span<const std::byte> payload, Scene& scene)
+    {
+        auto& trigger = Access::get(scene);
+        trigger.midiChannel =
+            (int(payload[byte] & 0x0F_b) + 1) * int(trigger.enabled);
+    }
+
+    static bool validate(const Scene& scene)
+    {
+        const auto& trigger = Access::get(scene);
+        return !trigger.enabled || unsigned(trigger.midiChannel) <= 16;
+    }
+};
+
+template <size_t index>
+struct TriggerAction : layout::Member<triggerPath(index, SceneField::action),
+                                      TriggerAccess<index>,
+                                      &Scene::Trigger::action>
+{
+    using Access = TriggerAccess<index>;
+    static constexpr auto& positions = triggers[index];
+
+    static void encode(const Scene& scene, std::span<std::byte> payload)
+    {
+        const auto& action = Access::get(scene).action;
+        if (const auto* note = std::get_if<Scene::Note>(&action))
+        {
+            const auto* fixed = std::get_if<Value7bit>(&note->velocity);
+            payload[positions.id] = std::byte(note->note);
+            payload[positions.velocity] =
+                fixed ? std::byte(*fixed)
+                      : std::byte(std::get<Scene::Note::VelocityCurve>(
+                            note->velocity));
+            if constexpr (positions.velocityType.has_value())
+                layout::set<*positions.velocityType>(payload, fixed);
+            // That seems to be the default initialization in the controller
+            payload[positions.value] = 0x7F_b;
+        }
+        else
+        {
+            const auto& control = std::get<Scene::Control>(action);
+            layout::set<positions.actionType>(payload, true);
+            payload[positions.id] = std::byte(control.param);
+            payload[positions.value] = std::byte(control.value);
+            payload[positions.releaseValue] = std::byte(control.releaseValue);
+        }
+    }
+
+    static void decode(std::span<const std::byte> payload, Scene& scene)
+    {
+        auto& trigger = Access::get(scene);
+        const auto id = Value7bit(payload[positions.id]);
+
+        if (layout::test<positions.actionType>(payload))
+        {
+            trigger.action =
+                Scene::Control{.param = id,
+                               .value = Value7bit(payload[positions.value]),
+                               .releaseValue =
+                                   Value7bit(payload[positions.releaseValue])};
+            return;
+        }
+
+        Scene::Note note{.note = id};
+        const auto velocity = Value7bit(payload[positions.velocity]);
+        bool fixed = true;
+        if constexpr (positions.velocityType.has_value())
+            fixed = layout::test<*positions.velocityType>(payload);
+        if (fixed)
+            note.velocity = velocity;
+        else
+            note.velocity = Scene::Note::VelocityCurve(velocity);
+        trigger.action = note;
+    }
+
+    static bool validate(const Scene& scene)
+    {
+        const auto& action = Access::get(scene).action;
+        if (const auto* note = std::get_if<Scene::Note>(&action))
+        {
+            if (note->note > 0x7F)
+                return false;
+            const auto* fixed = std::get_if<Value7bit>(&note->velocity);
+            if (!fixed)
+            {
+                return positions.velocityType.has_value() &&
+                       int(std::get<Scene::Note::VelocityCurve>(
+                           note->velocity)) < 8;
+            }
+            return *fixed <= 0x7F;
+        }
+        const auto& control = std::get<Scene::Control>(action);
+        return (control.param | control.value | control.releaseValue) <= 0x7F;
+    }
+};
+
+template <size_t index>
+struct KnobType : layout::Member<knobPath(index, SceneField::knobType),
+                                 KnobAccess<index>, &Scene::Knob::type>
+{
+    using Access = KnobAccess<index>;
+    static constexpr auto byte = knobs[index].type;
+
+    static void encode(const Scene& scene, std::span<std::byte> payload)
+    {
+        const auto& knob = Access::get(scene);
+        payload[byte] |= std::byte(int(knob.type) * int(knob.enabled)) << 4;
+    }
+
+    static void decode(std::span<const std::byte> payload, Scene& scene)
+    {
+        auto& knob = Access::get(scene);
+        const auto type = std::to_integer<int>(payload[byte] >> 4);
+        knob.enabled = type != 0;
+        knob.type = knob.enabled ? Scene::KnobType(type) : knob.type;
+    }
+
+    static bool validate(const Scene& scene)
+    {
+        const auto type = Access::get(scene).type;
+        return type >= Scene::KnobType::PitchBend &&
+               type <= Scene::KnobType::Controller;
+    }
+
+    static bool equal(const Scene& lhs, const Scene& rhs)
+    {
+        const auto& a = Access::get(lhs);
+        const auto& b = Access::get(rhs);
+        return a.enabled == b.enabled && a.type == b.type;
+    }
+};
+
+// The release value is -128..127 for pitch bend, 0..127 otherwise.
+// Requires the knob type to be decoded first.
+template <size_t index>
+struct AxisReleaseValue
+    : layout::Member<knobPath(index + 2, SceneField::releaseValue),
+                     KnobAccess<index + 2>, &Scene::Axis::releaseValue>
+{
+    using Access = KnobAccess<index + 2>;
+    static constexpr auto& positions = axes[index];
+
+    static void encode(const Scene& scene, std::span<std::byte> payload)
+    {
+        const auto& axis = Access::get(scene);
+        const int value = axis.releaseValue;
+        const bool pitchBend = axis.type == Scene::KnobType::PitchBend;
+        payload[positions.releaseValue] =
+            std::byte(pitchBend ? value & 0x7F : (value << 1) & 0x7E);
+        layout::set<positions.releaseValueSign>(
+            payload, pitchBend ? value >= 0 : value >= 64);
+    }
+
+    static void decode(std::span<const std::byte> payload, Scene& scene)
+    {
+        auto& axis = Access::get(scene);
+        const int value = std::to_integer<int>(payload[positions.releaseValue]);
+        const bool sign = layout::test<positions.releaseValueSign>(payload);
+        axis.releaseValue = axis.type == Scene::KnobType::PitchBend
+                                ? value - (sign ? 0 : 128)
+                                : (value >> 1) + (sign ? 0x40 : 0);
+    }
+
+    static bool validate(const Scene& scene)
+    {
+        const auto& axis = Access::get(scene);
+        return axis.type == Scene::KnobType::PitchBend ||
+               (axis.releaseValue >= 0 && axis.releaseValue <= 127);
+    }
+};
+
+// Field lists
+
+template <size_t index>
+using TriggerFields = mp::Types<
+    layout::Flag<triggerPath(index, SceneField::enabled), TriggerAccess<index>,
+                 &Scene::Trigger::enabled, Bit{triggers[index].channel, 4}>,
+    TriggerChannel<index>,
+    layout::Flag<triggerPath(index, SceneField::switchType),
+                 TriggerAccess<index>, &Scene::Trigger::type,
+                 Bit{triggers[index].channel, 5}>,
+    layout::Flag<triggerPath(index, SceneField::port), TriggerAccess<index>,
+                 &Scene::Trigger::port, triggers[index].port>,
+    layout::Flag<triggerPath(index, SceneField::flamRoll),
+                 TriggerAccess<index>, &Scene::Trigger::hasFlamRoll,
+                 triggers[index].flamRoll>,
+    TriggerAction<index>>;
+
+template <size_t index>
+using KnobFields = mp::Types<
+    KnobType<index>,
+    layout::Flag<knobPath(index, SceneField::polarity), KnobAccess<index>,
+                 &Scene::Knob::reversePolarity, Bit{knobs[index].type, 1}>,
+    layout::Byte<knobPath(index, SceneField::parameter), KnobAccess<index>,
+                 &Scene::Knob::param, knobs[index].param>,
+    layout::Bits<knobPath(index, SceneField::padAssignment), KnobAccess<index>,
+                 &Scene::Knob::padAssignmentBits, knobs[index].pads>,
+    layout::Flag<knobPath(index, SceneField::pedalAssignment),
+                 KnobAccess<index>, &Scene::Knob::pedalAssigned,
+                 Bit{knobs[index].type, 0}>>;
+
+template <size_t index>
+using AxisFields =
+    mp::join<KnobFields<index + 2>, mp::Types<AxisReleaseValue<index>>>;
+
+// The roll speed range is 40-240
+template <size_t index>
+using RepeaterFields = mp::Types<
+    layout::SplitByte<repeaterPath(index, SceneField::minSpeed),
+                      RepeaterAccess<index>, &Scene::Repeater::minSpeed,
+                      repeaters[index].minSpeed, repeaters[index].minSpeedHigh,
+                      index == 1 ? 40 : 0>,
+    layout::SplitByte<repeaterPath(index, SceneField::maxSpeed),
+                      RepeaterAccess<index>, &Scene::Repeater::maxSpeed,
+                      repeaters[index].maxSpeed, repeaters[index].maxSpeedHigh,
+                      0, index == 1 ? 240 : 255>,
+    layout::Byte<repeaterPath(index, SceneField::minVolume),
+                 RepeaterAccess<index>, &Scene::Repeater::minVolume,
+                 repeaters[index].minVolume>,
+    layout::Byte<repeaterPath(index, SceneField::maxVolume),
+                 RepeaterAccess<index>, &Scene::Repeater::maxVolume,
+                 repeaters[index].maxVolume>>;
+
+template <size_t... indices>
+auto triggerFields(std::index_sequence<indices...>)
+    -> mp::join<TriggerFields<indices>...>;
+
+using Fields = mp::join<
+    decltype(triggerFields(std::make_index_sequence<17>{})), KnobFields<0>,
+    KnobFields<1>, AxisFields<0>, AxisFields<1>, RepeaterFields<0>,
+    RepeaterFields<1>,
+    mp::Types<layout::Byte<ScenePath{SceneSection::fixedVelocity, 0,
+                                     SceneField::value},
+                           SceneAccess, &Scene::fixedVelocity,
+                           fixedVelocity>>>;
+
+template <typename... Ts>
+using SceneCodec = layout::Codec<Scene, Ts...>;
+
+using Codec = mp::apply<SceneCodec, Fields>;
+
+static_assert(Codec::fieldCount == sceneFieldCount);
+
+} // namespace paddock::midi::korgPadKontrol::sceneLayout
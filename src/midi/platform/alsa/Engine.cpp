@@ -68,16 +68,6 @@ std::optional<PortInfo> getPortInfo(snd_seq_t* handle, int client, int port)
     return portInfo;
 }
 
-std::shared_ptr<snd_seq_client_info_t> getClientInfo(const ClientId& clientId)
-{
-    return std::static_pointer_cast<snd_seq_client_info_t>(clientId);
-}
-
-int getAlsaClientId(const ClientId& clientId)
-{
-    return snd_seq_client_info_get_client(getClientInfo(clientId).get());
-}
-
 struct HwPortInfo
 {
     std::string deviceId;
@@ -175,18 +165,23 @@ PortNameToDeviceMap getHwMidiDevices()
     return portToDevice;
 }
 
-ClientInfo makeClientInfo(snd_seq_t* handle, ClientId clientId,
-                          const PortNameToDeviceMap& portToDevice)
+std::optional<ClientInfo> makeClientInfo(
+    snd_seq_t* handle, const ClientId& clientId,
+    const PortNameToDeviceMap& portToDevice)
 {
-    ClientInfo result;
-    auto info = getClientInfo(clientId);
+    snd_seq_client_info_t* info;
+    snd_seq_client_info_alloca(&info);
+    // The index of the id is the ALSA client number.
+    const auto alsaClientId = int(clientId.index);
+    if (snd_seq_get_any_client_info(handle, alsaClientId, info) < 0)
+        return std::nullopt;
 
-    result.name = snd_seq_client_info_get_name(info.get());
-    result.type = getClientType(info.get());
-    result.id = std::move(clientId);
+    ClientInfo result;
+    result.name = snd_seq_client_info_get_name(info);
+    result.type = getClientType(info);
+    result.id = clientId;
 
-    auto alsaClientId = snd_seq_client_info_get_client(info.get());
-    auto numPorts = snd_seq_client_info_get_num_ports(info.get());
+    auto numPorts = snd_seq_client_info_get_num_ports(info);
 
     for (int i = 0; i < numPorts; ++i)
     {
@@ -234,22 +229,6 @@ std::shared_ptr<void> getPollDescriptor(snd_seq_t* client)
     return std::static_pointer_cast<void>(fd);
 }
 
-void removeClient(ClientId id, std::vector<ClientIds>& clients)
-{
-    if (!id)
-        return;
-    clients.erase(std::find_if(
-        clients.begin(), clients.end(),
-        [&id](const ClientIds& ids) { return std::get<ClientId>(ids) == id; }));
-}
-
-bool isValid(const ClientId& id)
-{
-    if (!id)
-        return false;
-    return snd_seq_client_info_get_type(getClientInfo(id).get()) != 0;
-}
-
 } // namespace
 
 Expected<Engine> Engine::create()
@@ -301,7 +280,7 @@ Engine::Engine(Handle handle)
         if (id == thisId)
             continue;
 
-        _clients.push_back(std::make_tuple(id, makeClientId(info)));
+        _clients.add(_clients.makeId(uint32_t(id)));
     }
 }
 
@@ -328,40 +307,26 @@ std::vector<ClientInfo> Engine::queryClientInfos() const
     const auto portToDevice = getHwMidiDevices();
 
     std::vector<ClientInfo> result;
-
-    for (const auto& client : _clients)
-    {
-        if (!isValid(std::get<ClientId>(client)))
-            continue;
-
-        result.push_back(makeClientInfo(
-            _handle.get(), std::get<ClientId>(client), portToDevice));
-    }
+    _clients.forEach([this, &result, &portToDevice](const ClientId& id) {
+        if (auto info = makeClientInfo(_handle.get(), id, portToDevice))
+            result.push_back(std::move(*info));
+    });
     return result;
 }
 
 std::optional<ClientInfo> Engine::queryClientInfo(const ClientId& id) const
 {
-    if (!isValid(id))
-        return {};
-
     // Check if the client if still in the list
     {
         std::unique_lock<std::mutex> lock(_clientMutex);
-        if (std::find_if(_clients.begin(), _clients.end(),
-                         [&id](const ClientIds& ids) {
-                             return std::get<ClientId>(ids) == id;
-                         }) == _clients.end())
-        {
+        if (!_clients.contains(id))
             return std::nullopt;
-        }
     }
 
-    auto clientInfo = getClientInfo(id);
-    // This function may still return old data if the client has been
-    // disconnected between the verification above and they data query here
-    return makeClientInfo(_handle.get(), std::move(clientInfo),
-                          getHwMidiDevices());
+    // This function may still return the data of a new client with the same
+    // number if the client has been disconnected between the verification
+    // above and they data query here
+    return makeClientInfo(_handle.get(), id, getHwMidiDevices());
 }
 
 std::shared_ptr<void> Engine::pollHandle() const
@@ -419,48 +384,20 @@ std::optional<Expected<events::EngineEvent>> Engine::_extractEvent() const
     auto result = snd_seq_event_input(_handle.get(), &event);
     if (result < 0)
         return tl::make_unexpected(EngineError::readEventFailed);
-    return makeEvent(event, const_cast<snd_seq_t*>(_handle.get()), _clients);
+    return makeEvent(event, _clients);
 }
 
 void Engine::_processEvent(const events::EngineEvent& event)
 {
-    std::visit(overloaded{[this](const events::ClientChange& event) {
-                              _updateClientInfo(event.client);
-                          },
-                          [this](const events::ClientStart& event) {
-                              _clients.push_back(std::make_tuple(
-                                  getAlsaClientId(event.client), event.client));
+    // The client information is queried when needed, only the ids are kept.
+    std::visit(overloaded{[this](const events::ClientStart& event) {
+                              _clients.add(event.client);
                           },
                           [this](const events::ClientExit& event) {
-                              removeClient(event.client, _clients);
-                          },
-                          [this](const events::PortChange& event) {
-                              _updateClientInfo(event.client);
+                              _clients.remove(event.client);
                           },
-                          [this](const events::PortExit& event) {
-                              _updateClientInfo(event.client);
-                          },
-                          [this](const events::PortStart& event) {
-                              _updateClientInfo(event.client);
-                          },
-                          [this](auto&&) {}},
+                          [](auto&&) {}},
                event);
 }
 
-void Engine::_updateClientInfo(const ClientId& id)
-{
-    for (auto client : _clients)
-    {
-        if (std::get<ClientId>(client) != id)
-            continue;
-
-        snd_seq_client_info_t* info;
-        snd_seq_client_info_alloca(&info);
-        snd_seq_get_any_client_info(_handle.get(), std::get<int>(client), info);
-        auto oldInfo = getClientInfo(std::get<ClientId>(client));
-        snd_seq_client_info_copy(oldInfo.get(), info);
-        break;
-    }
-}
-
 } // namespace paddock::midi::alsa
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Sequencer.hpp"
+#include "utils.hpp"
 
 #include "midi/Client.hpp"
 #include "midi/events.hpp"
@@ -10,11 +11,11 @@
 
 namespace paddock::midi::alsa
 {
-using ClientIds = std::tuple<int, ClientId>;
-
 class Engine
 {
 public:
+    static constexpr EngineBackend backend = EngineBackend::alsa;
+
     static Expected<Engine> create();
 
     ~Engine();
@@ -37,19 +38,15 @@ public:
 
 private:
     using Handle = std::unique_ptr<snd_seq_t, int (*)(snd_seq_t*)>;
-    using ClientInfoHandle =
-        std::unique_ptr<snd_seq_client_info_t, int (*)(snd_seq_client_info_t*)>;
-
     Handle _handle;
     std::shared_ptr<void> _pollHandle;
 
     mutable std::mutex _clientMutex;
-    std::vector<ClientIds> _clients;
+    Clients _clients;
     mutable std::optional<Expected<events::EngineEvent>> _nextEvent;
 
     Engine(Handle handle);
     std::optional<Expected<events::EngineEvent>> _extractEvent() const;
     void _processEvent(const events::EngineEvent& event);
-    void _updateClientInfo(const ClientId& id);
 };
 } // namespace paddock::midi::alsa
@@ -31,6 +31,8 @@ class AlsaSeqErrorCategory : public std::error_category
             return "Error reading MIDI event";
         case Error::writeEventFailed:
             return "Error writing MIDI event";
+        case Error::setEventFilterFailed:
+            return "Error setting the ALSA sequencer client event filter";
         default:
             throw std::logic_error("Unknown error code");
         }
@@ -135,6 +137,7 @@ Sequencer::Sequencer(Handle handle, ClientInfo info)
     , _outPollHandle{_clientInfo.outputs.size()
                          ? getPollDescriptor(_handle.get(), POLLOUT)
                          : core::PollHandle{}}
+    , _filter{compileFilter(EventFilter{})}
 {
 }
 
@@ -157,11 +160,9 @@ const ClientInfo& Sequencer::info() const
 std::error_code Sequencer::connectInput(const ClientInfo& source,
                                         unsigned int outPort)
 {
-    snd_seq_client_info_t* info =
-        static_cast<snd_seq_client_info_t*>(source.id.get());
-
     snd_seq_addr_t sender;
-    sender.client = snd_seq_client_info_get_client(info);
+    // The index of the id is the ALSA client number.
+    sender.client = static_cast<unsigned char>(source.id.index);
     sender.port = outPort;
 
     snd_seq_addr_t dest;
@@ -213,20 +214,77 @@ std::shared_ptr<void> Sequencer::pollHandle(PollEvents events) const
     }
 }
 
-bool Sequencer::hasEvents() const
+std::error_code Sequencer::setEventFilter(const EventFilter& filter)
 {
-    return snd_seq_event_input_pending(_handle.get(), 1) > 0;
+    _filter = compileFilter(filter);
+    // An event already read ahead may not pass the new filter.
+    if (_nextEvent && _nextEvent->has_value() &&
+        !filter.accepts(_nextEvent->value()))
+    {
+        _nextEvent = std::nullopt;
+    }
+
+    // Nothing to push down if the kernel has never been told to filter.
+    if (filter.acceptsAll() && !_kernelFilter)
+        return std::error_code{};
+
+    // snd_seq_set_client_event_filter can only add types to the filter,
+    // the client info is rewritten to be able to replace it.
+    snd_seq_client_info_t* info;
+    snd_seq_client_info_alloca(&info);
+    if (snd_seq_get_client_info(_handle.get(), info) < 0)
+        return Error::setEventFilterFailed;
+    snd_seq_client_info_event_filter_clear(info);
+    // An empty filter means all the events for the kernel.
+    if (!filter.acceptsAll())
+    {
+        for (size_t type = 0; type != _filter.types.size(); ++type)
+        {
+            if (_filter.types.test(type))
+                snd_seq_client_info_event_filter_add(info, int(type));
+        }
+    }
+    if (snd_seq_set_client_info(_handle.get(), info) < 0)
+        return Error::setEventFilterFailed;
+    _kernelFilter = !filter.acceptsAll();
+    return std::error_code{};
+}
+
+bool Sequencer::hasEvents()
+{
+    // The events rejected by the filter don't count, so the next accepted
+    // one needs to be read ahead.
+    if (!_nextEvent)
+        _nextEvent = _extractEvent();
+    return _nextEvent.has_value();
 }
 
 Expected<events::Event> Sequencer::readEvent()
 {
-    snd_seq_event_t* event;
-    // This result should tell us if there are events remaining in the buffer
-    // but in reality it always returns 1 in case of success
-    auto result = snd_seq_event_input(_handle.get(), &event);
-    if (result < 0)
+    if (!_nextEvent)
+        _nextEvent = _extractEvent();
+    if (!_nextEvent)
         return tl::make_unexpected(Error::readEventFailed);
-    return makeEvent(event);
+    auto event = std::move(*_nextEvent);
+    _nextEvent = std::nullopt;
+    return event;
+}
+
+std::optional<Expected<events::Event>> Sequencer::_extractEvent()
+{
+    while (snd_seq_event_input_pending(_handle.get(), 1) > 0)
+    {
+        snd_seq_event_t* event;
+        // This result should tell us if there are events remaining in the
+        // buffer but in reality it always returns 1 in case of success
+        if (snd_seq_event_input(_handle.get(), &event) < 0)
+            return tl::make_unexpected(Error::readEventFailed);
+        // The channel of the events that pass the type mask is checked
+        // before converting them too.
+        if (_filter.accepts(event))
+            return makeEvent(event);
+    }
+    return std::nullopt;
 }
 
 std::error_code Sequencer::postEvent(const events::Event& event)
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "events.hpp"
+
 #include "midi/Client.hpp"
+#include "midi/EventFilter.hpp"
 #include "midi/events.hpp"
 
 #include "utils/Expected.hpp"
@@ -8,6 +11,7 @@
 #include <alsa/asoundlib.h>
 
 #include <memory>
+#include <optional>
 #include <system_error>
 #include <thread>
 
@@ -23,7 +27,8 @@ public:
         portCreationFailed,
         portSubscriptionFailed,
         readEventFailed, // This can happen if the input buffer overran
-        writeEventFailed
+        writeEventFailed,
+        setEventFilterFailed
     };
 
     static Expected<Sequencer> open(const char* clientName,
@@ -44,7 +49,13 @@ public:
 
     std::shared_ptr<void> pollHandle(PollEvents events) const;
 
-    bool hasEvents() const;
+    /// The events rejected by the filter are discarded before converting
+    /// them, the kernel is told not to deliver them in the first place.
+    /// Must not be called while the events are being read.
+    std::error_code setEventFilter(const EventFilter& filter);
+
+    /// Reads ahead until an event accepted by the filter is found.
+    bool hasEvents();
     Expected<events::Event> readEvent();
     std::error_code postEvent(const events::Event& event);
 
@@ -57,9 +68,14 @@ private:
     std::shared_ptr<void> _inPollHandle;
     std::shared_ptr<void> _outPollHandle;
 
+    EventTypeFilter _filter;
+    bool _kernelFilter{false};
+    std::optional<Expected<events::Event>> _nextEvent;
+
     Sequencer(Handle handle, ClientInfo info);
 
     std::error_code _postEvent(snd_seq_event_t* event);
+    std::optional<Expected<events::Event>> _extractEvent();
 };
 
 } // namespace paddock::midi::alsa
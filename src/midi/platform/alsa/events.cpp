@@ -10,17 +10,6 @@
 
 namespace paddock::midi::alsa
 {
-namespace
-{
-ClientId makeClientIdFromAlsaId(snd_seq_t* handle, int id)
-{
-    snd_seq_client_info_t* info;
-    snd_seq_client_info_alloca(&info);
-    snd_seq_get_any_client_info(handle, id, info);
-    return makeClientId(info);
-}
-} // namespace
-
 std::vector<std::byte> copyExtData(const snd_seq_event_t* event)
 {
     auto dataPtr = static_cast<std::byte*>(event->data.ext.ptr);
@@ -208,29 +197,21 @@ events::Event makeEvent(const snd_seq_event_t* event)
     }
 }
 
-std::optional<events::EngineEvent> makeEvent(
-    const snd_seq_event_t* event, snd_seq_t* handle,
-    const std::vector<ClientIds>& clients)
+std::optional<events::EngineEvent> makeEvent(const snd_seq_event_t* event,
+                                             const Clients& clients)
 {
     using namespace midi::events;
 
-    auto findClient = [&clients](int id) {
-        for (auto client : clients)
-        {
-            if (std::get<int>(client) == id)
-                return std::get<ClientId>(client);
-        }
-        return ClientId{};
+    const auto findClient = [&clients](unsigned char number) {
+        return clients.find(number);
     };
 
     switch (event->type)
     {
     case SND_SEQ_EVENT_CLIENT_START:
-    {
-        ClientStart client{
-            makeClientIdFromAlsaId(handle, event->data.addr.client)};
-        return EngineEvent{std::move(client)};
-    }
+        return EngineEvent{
+            ClientStart{clients.makeId(event->data.addr.client)}};
+
     case SND_SEQ_EVENT_CLIENT_EXIT:
         return EngineEvent{ClientExit{findClient(event->data.addr.client)}};
 
@@ -537,4 +518,40 @@ snd_seq_event_t makeEvent(const events::Event& event)
     return snd_seq_event_t{};
 }
 
+EventTypeFilter compileFilter(const EventFilter& filter)
+{
+    EventTypeFilter result;
+    // Each type is converted once to find out what it becomes, so the
+    // filter can't disagree with makeEvent.
+    for (size_t type = 0; type != result.types.size(); ++type)
+    {
+        snd_seq_event_t event{};
+        event.type = static_cast<snd_seq_event_type_t>(type);
+        const auto converted = makeEvent(&event);
+        result.types[type] = filter.acceptsType(converted.index());
+        result.channels[type] = std::visit(
+            [&filter](const auto& e) -> uint16_t {
+                if constexpr (requires { e.channel; })
+                    return filter.channels();
+                else
+                    return 0xFFFF;
+            },
+            converted);
+    }
+    return result;
+}
+
+bool EventTypeFilter::accepts(const snd_seq_event_t* event) const
+{
+    if (!types.test(event->type))
+        return false;
+    const auto mask = channels[event->type];
+    if (mask == 0xFFFF)
+        return true;
+    const auto channel = snd_seq_ev_is_note_type(event)
+                             ? event->data.note.channel
+                             : event->data.control.channel;
+    return mask & (1 << (channel & 0x0F));
+}
+
 } // namespace paddock::midi::alsa
@@ -1,7 +1,15 @@
 #pragma once
 
+#include "utils.hpp"
+
+#include "midi/EventFilter.hpp"
 #include "midi/events.hpp"
 
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <optional>
+
 typedef struct snd_seq_event snd_seq_event_t;
 typedef struct _snd_seq snd_seq_t;
 
@@ -9,13 +17,28 @@ namespace paddock::midi::alsa
 {
 events::Event makeEvent(const snd_seq_event_t* event);
 
-std::optional<events::EngineEvent> makeEvent(
-    const snd_seq_event_t* event, snd_seq_t* handle,
-    const std::vector<std::tuple<int, ClientId>>& clients);
+/// The clients announced are given the id the table would give them, it's
+/// up to the caller to add them.
+std::optional<events::EngineEvent> makeEvent(const snd_seq_event_t* event,
+                                             const Clients& clients);
 
 // Make an ALSA seq event from an application event. Events that contain
 // variale length data must be kept alive while snd_seq_event_t is only
 // a pointer to the data will be stored.
 snd_seq_event_t makeEvent(const events::Event& event);
 
+/// An EventFilter compiled to the ALSA event types, to discard the events
+/// before converting them.
+struct EventTypeFilter
+{
+    std::bitset<256> types;
+    /// The channels accepted for each type, all of them for the types
+    /// without channel.
+    std::array<uint16_t, 256> channels;
+
+    bool accepts(const snd_seq_event_t* event) const;
+};
+
+EventTypeFilter compileFilter(const EventFilter& filter);
+
 } // namespace paddock::midi::alsa
@@ -1,13 +1,10 @@
 #pragma once
 
-#include "midi/types.hpp"
-
-#include <alsa/asoundlib.h>
+#include "midi/ClientTable.hpp"
 
 namespace paddock::midi::alsa
 {
-using ClientIds = std::tuple<int, ClientId>;
-
-ClientId makeClientId(snd_seq_client_info_t* info);
+/// The clients by their ALSA client number, which fits in a byte.
+using Clients = ClientTable<256>;
 
-} // namespace paddock::midi::alas
+} // namespace paddock::midi::alsa
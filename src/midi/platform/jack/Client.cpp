@@ -0,0 +1,428 @@
+#include "Client.hpp"
+
+#include "midi/messages.hpp"
+
+#include "core/errors.hpp"
+
+#include "utils/SpscQueue.hpp"
+
+#include <jack/jack.h>
+#include <jack/midiport.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <mutex>
+#include <optional>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace paddock::midi::jack
+{
+namespace
+{
+class JackClientErrorCategory : public std::error_category
+{
+    const char* name() const noexcept override { return "jack-client-error"; }
+    std::string message(int code) const override
+    {
+        using Error = Client::Error;
+        switch (static_cast<Error>(code))
+        {
+        case Error::openClientFailed:
+            return "Could not open JACK client, is the JACK server running?";
+        case Error::portRegistrationFailed:
+            return "Could not register JACK MIDI port";
+        case Error::activationFailed:
+            return "Could not activate JACK client";
+        case Error::portConnectionFailed:
+            return "Could not connect JACK MIDI ports";
+        case Error::readEventFailed:
+            return "No MIDI event to read";
+        case Error::outputQueueFull:
+            return "JACK MIDI output queue full";
+        default:
+            throw std::logic_error("Unknown error code");
+        }
+    }
+    bool equivalent(int code, const std::error_condition& condition) const
+        noexcept override
+    {
+        return (condition == core::ErrorType::midi);
+    }
+};
+
+const JackClientErrorCategory jackClientErrorCategory{};
+
+// Enough for a burst of a whole controller scene in a period.
+constexpr size_t queueCapacity = 1024;
+
+constexpr bool isRead(PortDirection direction)
+{
+    return direction == PortDirection::read ||
+           direction == PortDirection::duplex;
+}
+
+constexpr bool isWrite(PortDirection direction)
+{
+    return direction == PortDirection::write ||
+           direction == PortDirection::duplex;
+}
+
+struct TimedMessage
+{
+    jack_nframes_t frame;
+    ShortMessage message;
+};
+
+std::optional<std::string> portName(const ClientInfo& client,
+                                     const std::vector<PortInfo>& ports,
+                                     unsigned int number)
+{
+    const auto port =
+        std::find_if(ports.begin(), ports.end(), [number](const auto& port) {
+            return port.number == int(number);
+        });
+    if (port == ports.end())
+        return std::nullopt;
+    return client.name + ":" + port->name;
+}
+} // namespace
+
+std::error_code make_error_code(Client::Error error)
+{
+    return std::error_code{static_cast<int>(error), jackClientErrorCategory};
+}
+
+class Client::_Impl
+{
+public:
+    _Impl(jack_client_t* client, ClientInfo info, jack_port_t* inPort,
+          jack_port_t* outPort, int eventFd)
+        : _client{client}
+        , _info{std::move(info)}
+        , _inPort{inPort}
+        , _outPort{outPort}
+        , _eventFd{eventFd}
+        , _pollHandle{_inPort ? std::make_shared<pollfd>(
+                                    pollfd{_eventFd, POLLIN, 0})
+                              : std::shared_ptr<pollfd>{}}
+    {
+    }
+
+    ~_Impl()
+    {
+        jack_deactivate(_client);
+        jack_client_close(_client);
+        ::close(_eventFd);
+    }
+
+    std::error_code activate()
+    {
+        if (jack_set_process_callback(_client, &_Impl::_process, this) != 0 ||
+            jack_activate(_client) != 0)
+        {
+            return Error::activationFailed;
+        }
+        return std::error_code{};
+    }
+
+    const ClientInfo& info() const { return _info; }
+
+    std::error_code connect(const std::optional<std::string>& source,
+                            const std::optional<std::string>& destination)
+    {
+        if (!source || !destination)
+            return Error::portConnectionFailed;
+        const auto result =
+            jack_connect(_client, source->c_str(), destination->c_str());
+        if (result != 0 && result != EEXIST)
+            return Error::portConnectionFailed;
+        return std::error_code{};
+    }
+
+    std::shared_ptr<void> pollHandle() const { return _pollHandle; }
+
+    void setEventFilter(const EventFilter& filter)
+    {
+        _filter = filter;
+        if (_next && !_filter.accepts(*_next))
+            _next.reset();
+    }
+
+    bool hasEvents()
+    {
+        if (_next)
+            return true;
+        _next = _popEvent();
+        if (_next)
+            return true;
+
+        // The eventfd is cleared before checking the queue again, a message
+        // queued after the check signals it again.
+        uint64_t count;
+        [[maybe_unused]] const auto result =
+            ::read(_eventFd, &count, sizeof(count));
+        _next = _popEvent();
+        return bool(_next);
+    }
+
+    Expected<events::Event> readEvent()
+    {
+        if (!hasEvents())
+            return tl::make_unexpected(Error::readEventFailed);
+        auto event = std::move(*_next);
+        _next.reset();
+        return event;
+    }
+
+    std::error_code postEvent(const events::Event& event)
+    {
+        const auto message = encodeShortMessage(event);
+        if (!message || !_outPort)
+            return std::error_code{};
+
+        // The queue has a single producer, the lock only serializes the
+        // threads posting events, never the process callback.
+        std::lock_guard<std::mutex> lock(_postMutex);
+        if (!_output.push(TimedMessage{jack_frame_time(_client), *message}))
+            return Error::outputQueueFull;
+        return std::error_code{};
+    }
+
+private:
+    jack_client_t* _client;
+    ClientInfo _info;
+    jack_port_t* _inPort;
+    jack_port_t* _outPort;
+    int _eventFd;
+    std::shared_ptr<pollfd> _pollHandle;
+
+    // Process callback -> poll thread
+    SpscQueue<ShortMessage> _input{queueCapacity};
+    std::optional<events::Event> _next;
+    EventFilter _filter;
+
+    // Posting threads -> process callback
+    std::mutex _postMutex;
+    SpscQueue<TimedMessage> _output{queueCapacity};
+    std::optional<TimedMessage> _pending; // Only used by the process callback
+
+    /// @return the next message accepted by the filter, if any
+    std::optional<events::Event> _popEvent()
+    {
+        while (const auto message = _input.pop())
+        {
+            auto event = decodeShortMessage(
+                std::span{message->data.data(), message->size});
+            if (!event)
+                event = events::Unknown{};
+            if (_filter.accepts(*event))
+                return event;
+        }
+        return std::nullopt;
+    }
+
+    static int _process(jack_nframes_t frames, void* arg)
+    {
+        auto* self = static_cast<_Impl*>(arg);
+        if (self->_inPort)
+            self->_readInput(frames);
+        if (self->_outPort)
+            self->_writeOutput(frames);
+        return 0;
+    }
+
+    void _readInput(jack_nframes_t frames)
+    {
+        void* buffer = jack_port_get_buffer(_inPort, frames);
+        const auto count = jack_midi_get_event_count(buffer);
+        bool received = false;
+        for (uint32_t i = 0; i != count; ++i)
+        {
+            jack_midi_event_t event;
+            // SysEx messages aren't transported.
+            if (jack_midi_event_get(&event, buffer, i) != 0 ||
+                event.size == 0 || event.size > 3)
+            {
+                continue;
+            }
+            ShortMessage message{{}, uint8_t(event.size)};
+            std::copy_n(event.buffer, event.size, message.data.begin());
+            // Dropped if the poll thread doesn't keep up.
+            received |= _input.push(message);
+        }
+
+        if (received)
+        {
+            // Non blocking, the counter can't overflow in practice.
+            const uint64_t one = 1;
+            [[maybe_unused]] const auto result =
+                ::write(_eventFd, &one, sizeof(one));
+        }
+    }
+
+    void _writeOutput(jack_nframes_t frames)
+    {
+        void* buffer = jack_port_get_buffer(_outPort, frames);
+        jack_midi_clear_buffer(buffer);
+
+        const auto cycleStart = jack_last_frame_time(_client);
+        jack_nframes_t lastOffset = 0;
+        while (true)
+        {
+            if (!_pending)
+            {
+                _pending = _output.pop();
+                if (!_pending)
+                    return;
+            }
+
+            // A message posted at frame f in the previous period is played
+            // at f + period. The difference is signed to handle the wrap
+            // around of the frame counter and messages that arrived late.
+            const auto offset =
+                int32_t(_pending->frame + frames - cycleStart);
+            if (offset >= int32_t(frames))
+                return; // Posted during this period, played in the next one
+
+            // JACK requires the events ordered by time.
+            lastOffset =
+                std::max(lastOffset, jack_nframes_t(std::max(offset, 0)));
+            const auto& message = _pending->message;
+            // If the buffer is full the message is dropped.
+            jack_midi_event_write(buffer, lastOffset, message.data.data(),
+                                  message.size);
+            _pending.reset();
+        }
+    }
+};
+
+Expected<Client> Client::open(const char* clientName, PortDirection direction)
+{
+    jack_status_t status;
+    jack_client_t* client =
+        jack_client_open(clientName, JackNoStartServer, &status);
+    if (!client)
+        return tl::make_unexpected(Error::openClientFailed);
+
+    const auto registerPort = [client](const char* name, unsigned long flags) {
+        return jack_port_register(client, name, JACK_DEFAULT_MIDI_TYPE, flags,
+                                  0);
+    };
+
+    // The port numbers are only meaningful within the client.
+    ClientInfo info{.name = jack_get_client_name(client),
+                    .type = ClientType::user};
+    jack_port_t* inPort = nullptr;
+    if (isWrite(direction))
+    {
+        inPort = registerPort("in", JackPortIsInput);
+        if (!inPort)
+        {
+            jack_client_close(client);
+            return tl::make_unexpected(Error::portRegistrationFailed);
+        }
+        info.inputs.push_back(PortInfo{.name = "in", .number = 0});
+    }
+
+    jack_port_t* outPort = nullptr;
+    if (isRead(direction))
+    {
+        outPort = registerPort("out", JackPortIsOutput);
+        if (!outPort)
+        {
+            jack_client_close(client);
+            return tl::make_unexpected(Error::portRegistrationFailed);
+        }
+        info.outputs.push_back(
+            PortInfo{.name = "out", .number = int(info.inputs.size())});
+    }
+
+    const int eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd == -1)
+    {
+        jack_client_close(client);
+        return tl::make_unexpected(
+            std::make_error_code(static_cast<std::errc>(errno)));
+    }
+
+    // From here on the client is closed by _Impl.
+    auto impl = std::make_unique<_Impl>(client, std::move(info), inPort,
+                                        outPort, eventFd);
+    if (auto error = impl->activate())
+        return tl::make_unexpected(error);
+    return Client{std::move(impl)};
+}
+
+Client::Client(std::unique_ptr<_Impl> impl)
+    : _impl{std::move(impl)}
+{
+}
+
+Client::~Client() = default;
+
+Client::Client(Client&& other) noexcept = default;
+Client& Client::operator=(Client&& other) noexcept = default;
+
+const ClientInfo& Client::info() const
+{
+    return _impl->info();
+}
+
+std::error_code Client::connectInput(const ClientInfo& source,
+                                     unsigned int outPort)
+{
+    const auto& info = _impl->info();
+    if (info.inputs.empty())
+        return Error::portConnectionFailed;
+    return _impl->connect(portName(source, source.outputs, outPort),
+                          portName(info, info.inputs, info.inputs[0].number));
+}
+
+std::error_code Client::connectOutput(const ClientInfo& destination,
+                                      unsigned int inPort)
+{
+    const auto& info = _impl->info();
+    if (info.outputs.empty())
+        return Error::portConnectionFailed;
+    return _impl->connect(portName(info, info.outputs, info.outputs[0].number),
+                          portName(destination, destination.inputs, inPort));
+}
+
+std::shared_ptr<void> Client::pollHandle(PollEvents events) const
+{
+    switch (events)
+    {
+    case PollEvents::in:
+        return _impl->pollHandle();
+    case PollEvents::out:
+        return std::shared_ptr<void>{};
+    default:
+        throw std::logic_error("invalid value");
+    }
+}
+
+std::error_code Client::setEventFilter(const EventFilter& filter)
+{
+    _impl->setEventFilter(filter);
+    return std::error_code{};
+}
+
+bool Client::hasEvents()
+{
+    return _impl->hasEvents();
+}
+
+Expected<events::Event> Client::readEvent()
+{
+    return _impl->readEvent();
+}
+
+std::error_code Client::postEvent(const events::Event& event)
+{
+    return _impl->postEvent(event);
+}
+
+} // namespace paddock::midi::jack
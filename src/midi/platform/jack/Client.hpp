@@ -0,0 +1,87 @@
+#pragma once
+
+#include "midi/Client.hpp"
+#include "midi/EventFilter.hpp"
+#include "midi/events.hpp"
+
+#include "utils/Expected.hpp"
+
+#include <memory>
+#include <system_error>
+
+namespace paddock::midi::jack
+{
+/// A JACK client with a MIDI input port, a MIDI output port or both.
+///
+/// The events posted are encoded and queued without blocking, the JACK
+/// process callback writes them into the output buffer one period after
+/// they were posted, at the same frame offset they had in the period in
+/// which they were posted. That gives a constant latency of one period
+/// instead of the jitter of writing them all at the start of the next one.
+/// The input is queued by the process callback and read from the poll thread
+/// through an eventfd.
+///
+/// Only channel voice events are written, the others are ignored. The clock
+/// and song position are also read, e.g. to follow the tempo of a sequencer.
+class Client
+{
+public:
+    enum class Error
+    {
+        openClientFailed = 1,
+        portRegistrationFailed,
+        activationFailed,
+        portConnectionFailed,
+        readEventFailed,
+        outputQueueFull
+    };
+
+    /// The client doesn't start a JACK server if none is running.
+    static Expected<Client> open(const char* clientName,
+                                 PortDirection direction);
+
+    ~Client();
+
+    Client(Client&& other) noexcept;
+    Client& operator=(Client&& other) noexcept;
+
+    Client(const Client& other) = delete;
+    Client& operator=(const Client& other) = delete;
+
+    const ClientInfo& info() const;
+
+    /// The ports are connected by name, other is expected to be a JACK
+    /// client, e.g. another paddock::midi::jack::Client or an ALSA device
+    /// bridged by a2jmidid with the same name.
+    std::error_code connectInput(const ClientInfo& other, unsigned int outPort);
+    std::error_code connectOutput(const ClientInfo& other, unsigned int inPort);
+
+    /// Only the input handle is available.
+    std::shared_ptr<void> pollHandle(PollEvents events) const;
+
+    /// The messages are filtered after the process callback has queued
+    /// them, JACK has nothing to push the filter down to.
+    std::error_code setEventFilter(const EventFilter& filter);
+
+    bool hasEvents();
+    Expected<events::Event> readEvent();
+    std::error_code postEvent(const events::Event& event);
+
+private:
+    class _Impl;
+    std::unique_ptr<_Impl> _impl;
+
+    Client(std::unique_ptr<_Impl> impl);
+};
+
+} // namespace paddock::midi::jack
+
+#include <system_error>
+
+namespace std
+{
+template <>
+struct is_error_code_enum<paddock::midi::jack::Client::Error> : true_type
+{
+};
+} // namespace std
@@ -0,0 +1,87 @@
+#include "Engine.hpp"
+
+#include "midi/errors.hpp"
+
+#include <jack/jack.h>
+
+namespace paddock::midi::jack
+{
+Expected<Engine> Engine::create()
+{
+    // Probe the server with a short lived client.
+    jack_status_t status;
+    jack_client_t* probe =
+        jack_client_open("paddock-probe", JackNoStartServer, &status);
+    if (!probe)
+        return tl::make_unexpected(EngineError::initializationFailed);
+    jack_client_close(probe);
+
+#if PADDOCK_USE_ALSA
+    return alsa::Engine::create().and_then(
+        [](alsa::Engine&& devices) -> Expected<Engine> {
+            return Engine{std::move(devices)};
+        });
+#else
+    return Engine{};
+#endif
+}
+
+#if PADDOCK_USE_ALSA
+Engine::Engine(alsa::Engine devices)
+    : _devices{std::move(devices)}
+{
+}
+#endif
+
+Expected<Client> Engine::openClient(const char* name, PortDirection direction)
+{
+    return Client::open(name, direction);
+}
+
+std::vector<ClientInfo> Engine::queryClientInfos() const
+{
+#if PADDOCK_USE_ALSA
+    return _devices.queryClientInfos();
+#else
+    return {};
+#endif
+}
+
+std::optional<ClientInfo> Engine::queryClientInfo(const ClientId& id) const
+{
+#if PADDOCK_USE_ALSA
+    return _devices.queryClientInfo(id);
+#else
+    (void)id;
+    return std::nullopt;
+#endif
+}
+
+std::shared_ptr<void> Engine::pollHandle() const
+{
+#if PADDOCK_USE_ALSA
+    return _devices.pollHandle();
+#else
+    return std::shared_ptr<void>{};
+#endif
+}
+
+bool Engine::hasEvents() const
+{
+#if PADDOCK_USE_ALSA
+    return _devices.hasEvents();
+#else
+    return false;
+#endif
+}
+
+Expected<events::EngineEvent> Engine::readEvent()
+{
+#if PADDOCK_USE_ALSA
+    return _devices.readEvent();
+#else
+    return tl::make_unexpected(EngineError::readEventFailed);
+#endif
+}
+
+} // namespace paddock::midi::jack
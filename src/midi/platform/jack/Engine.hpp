@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Client.hpp"
+
+#include "midi/Client.hpp"
+#include "midi/events.hpp"
+
+#if PADDOCK_USE_ALSA
+#include "midi/platform/alsa/Engine.hpp"
+#endif
+
+#include <optional>
+
+namespace paddock::midi::jack
+{
+/// Engine whose clients are JACK clients.
+///
+/// JACK has no notion of hardware controllers, they are still discovered
+/// through the ALSA sequencer and opened through ALSA raw MIDI if ALSA is
+/// available. Without it no devices are listed.
+class Engine
+{
+public:
+    static constexpr EngineBackend backend = EngineBackend::jack;
+
+    /// Fails if no JACK server is running.
+    static Expected<Engine> create();
+
+    Expected<Client> openClient(const char* name, PortDirection direction);
+
+    std::vector<ClientInfo> queryClientInfos() const;
+    std::optional<ClientInfo> queryClientInfo(const ClientId& id) const;
+
+    std::shared_ptr<void> pollHandle() const;
+
+    bool hasEvents() const;
+    Expected<events::EngineEvent> readEvent();
+
+private:
+#if PADDOCK_USE_ALSA
+    alsa::Engine _devices;
+
+    Engine(alsa::Engine devices);
+#else
+    Engine() = default;
+#endif
+};
+
+} // namespace paddock::midi::jack
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "midi/ActiveNotes.hpp"
+
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi;
+
+std::vector<events::NoteOff> release(ActiveNotes& notes)
+{
+    std::vector<events::NoteOff> result;
+    notes.release(
+        [&result](const events::NoteOff& off) { result.push_back(off); });
+    return result;
+}
+} // namespace
+
+TEST(ActiveNotes, note_on_and_off)
+{
+    ActiveNotes notes;
+    EXPECT_TRUE(notes.empty());
+
+    notes.update(events::NoteOn{9, 36, 100});
+    notes.update(events::NoteOn{0, 127, 1});
+    notes.update(events::Controller{.channel = 0, .value = 1, .parameter = 2});
+    EXPECT_TRUE(notes.isOn(9, 36));
+    EXPECT_TRUE(notes.isOn(0, 127));
+    EXPECT_FALSE(notes.isOn(9, 37));
+    EXPECT_FALSE(notes.isOn(8, 36));
+
+    notes.update(events::NoteOff{9, 36, 64});
+    EXPECT_FALSE(notes.isOn(9, 36));
+    // Zero velocity is a note off
+    notes.update(events::NoteOn{0, 127, 0});
+    EXPECT_FALSE(notes.isOn(0, 127));
+    EXPECT_TRUE(notes.empty());
+}
+
+TEST(ActiveNotes, release)
+{
+    ActiveNotes notes;
+    notes.update(events::NoteOn{15, 127, 100});
+    notes.update(events::NoteOn{0, 0, 100});
+    notes.update(events::NoteOn{0, 64, 100});
+    notes.update(events::NoteOn{3, 63, 100});
+    // Twice on, released once
+    notes.update(events::NoteOn{3, 63, 100});
+
+    const auto offs = release(notes);
+    ASSERT_EQ(offs.size(), 4);
+    EXPECT_EQ(offs[0].channel, 0);
+    EXPECT_EQ(offs[0].note, 0);
+    EXPECT_EQ(offs[1].channel, 0);
+    EXPECT_EQ(offs[1].note, 64);
+    EXPECT_EQ(offs[2].channel, 3);
+    EXPECT_EQ(offs[2].note, 63);
+    EXPECT_EQ(offs[3].channel, 15);
+    EXPECT_EQ(offs[3].note, 127);
+
+    EXPECT_TRUE(notes.empty());
+    EXPECT_TRUE(release(notes).empty());
+}
+
+} // namespace paddock
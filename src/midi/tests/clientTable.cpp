@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "midi/ClientTable.hpp"
+
+#include <vector>
+
+namespace paddock
+{
+using namespace midi;
+
+TEST(ClientTable, add_and_remove)
+{
+    ClientTable<8> clients;
+    EXPECT_FALSE(clients.find(3));
+
+    const auto id = clients.makeId(3);
+    EXPECT_TRUE(id);
+    EXPECT_FALSE(clients.contains(id));
+    clients.add(id);
+    EXPECT_TRUE(clients.contains(id));
+    EXPECT_EQ(clients.find(3), id);
+
+    clients.remove(id);
+    EXPECT_FALSE(clients.contains(id));
+    EXPECT_FALSE(clients.find(3));
+}
+
+TEST(ClientTable, reused_numbers_get_new_ids)
+{
+    ClientTable<8> clients;
+    const auto first = clients.makeId(1);
+    clients.add(first);
+    clients.remove(first);
+
+    const auto second = clients.makeId(1);
+    EXPECT_NE(first, second);
+    clients.add(second);
+    EXPECT_FALSE(clients.contains(first));
+    EXPECT_TRUE(clients.contains(second));
+    // A stale id doesn't remove the new client
+    clients.remove(first);
+    EXPECT_TRUE(clients.contains(second));
+
+    // A client that starts again without leaving replaces the old one
+    const auto third = clients.makeId(1);
+    EXPECT_NE(third, second);
+    clients.add(third);
+    EXPECT_FALSE(clients.contains(second));
+    EXPECT_EQ(clients.find(1), third);
+}
+
+TEST(ClientTable, out_of_range)
+{
+    ClientTable<8> clients;
+    EXPECT_FALSE(clients.makeId(8));
+    clients.add(ClientId{8, 0});
+    EXPECT_FALSE(clients.find(8));
+    EXPECT_FALSE(clients.contains(ClientId{}));
+}
+
+TEST(ClientTable, for_each)
+{
+    ClientTable<8> clients;
+    for (uint32_t number : {5, 0, 7})
+        clients.add(clients.makeId(number));
+    clients.remove(clients.find(7));
+
+    std::vector<uint32_t> numbers;
+    clients.forEach(
+        [&numbers](const ClientId& id) { numbers.push_back(id.index); });
+    EXPECT_EQ(numbers, std::vector<uint32_t>({0, 5}));
+}
+
+} // namespace paddock
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "midi/EventFilter.hpp"
+
+namespace paddock
+{
+using namespace midi;
+
+TEST(EventFilter, accepts_all_by_default)
+{
+    const EventFilter filter;
+    EXPECT_TRUE(filter.acceptsAll());
+    EXPECT_TRUE(filter.accepts(events::NoteOn{15, 60, 100}));
+    EXPECT_TRUE(filter.accepts(events::ActiveSensing{}));
+    EXPECT_TRUE(filter.accepts(events::Unknown{}));
+}
+
+TEST(EventFilter, types)
+{
+    auto filter = EventFilter{}.reject<events::ActiveSensing, events::Clock>();
+    EXPECT_FALSE(filter.acceptsAll());
+    EXPECT_FALSE(filter.accepts(events::ActiveSensing{}));
+    EXPECT_FALSE(filter.accepts(events::Clock{}));
+    EXPECT_TRUE(filter.accepts(events::Start{}));
+    EXPECT_TRUE(filter.accepts(events::NoteOff{0, 60, 0}));
+
+    filter.accept<events::Clock>();
+    EXPECT_TRUE(filter.accepts(events::Clock{}));
+    EXPECT_FALSE(filter.accepts(events::ActiveSensing{}));
+
+    const auto index = events::Event{events::Clock{}}.index();
+    EXPECT_TRUE(filter.acceptsType(index));
+    EXPECT_EQ(index, (mp::indexOf<events::Clock, events::MidiTypes>));
+}
+
+TEST(EventFilter, none)
+{
+    const auto filter = EventFilter::none().accept<events::Clock>();
+    EXPECT_TRUE(filter.accepts(events::Clock{}));
+    EXPECT_FALSE(filter.accepts(events::Start{}));
+    EXPECT_FALSE(filter.accepts(events::NoteOn{9, 36, 100}));
+}
+
+TEST(EventFilter, channels)
+{
+    // Only channel 10 in 1-16 numbering
+    const auto filter = EventFilter{}.setChannels(1 << 9);
+    EXPECT_FALSE(filter.acceptsAll());
+    EXPECT_TRUE(filter.accepts(events::NoteOn{9, 36, 100}));
+    EXPECT_FALSE(filter.accepts(events::NoteOn{0, 36, 100}));
+    EXPECT_FALSE(
+        filter.accepts(events::Controller{.channel = 1, .parameter = 7}));
+    // The events without channel pass
+    EXPECT_TRUE(filter.accepts(events::Clock{}));
+    EXPECT_TRUE(filter.accepts(events::SysEx{}));
+}
+
+} // namespace paddock
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "midi/Engine.hpp"
+#include "midi/pads/KorgPadKontrol.hpp"
+#include "midi/platform/jack/Client.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <poll.h>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi;
+
+// Requires a running JACK server, e.g. jackd -d dummy.
+class JackClient : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto sender = jack::Client::open("paddock-test-out",
+                                         PortDirection::read);
+        if (!sender)
+            GTEST_SKIP() << sender.error().message();
+        auto receiver = jack::Client::open("paddock-test-in",
+                                           PortDirection::write);
+        ASSERT_TRUE(receiver);
+
+        _sender.emplace(std::move(*sender));
+        _receiver.emplace(std::move(*receiver));
+        ASSERT_FALSE(_sender->connectOutput(
+            _receiver->info(), _receiver->info().inputs[0].number));
+    }
+
+    std::vector<events::Event> receive(size_t count)
+    {
+        std::vector<events::Event> result;
+        auto* fd =
+            static_cast<pollfd*>(_receiver->pollHandle(PollEvents::in).get());
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds{2};
+        while (result.size() != count &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            ::poll(fd, 1, 100);
+            while (_receiver->hasEvents())
+            {
+                auto event = _receiver->readEvent();
+                EXPECT_TRUE(event);
+                if (event)
+                    result.push_back(*event);
+            }
+        }
+        return result;
+    }
+
+    std::optional<jack::Client> _sender;
+    std::optional<jack::Client> _receiver;
+};
+} // namespace
+
+TEST_F(JackClient, ports)
+{
+    EXPECT_TRUE(_sender->info().inputs.empty());
+    EXPECT_EQ(_sender->info().outputs.size(), 1);
+    EXPECT_EQ(_receiver->info().inputs.size(), 1);
+    EXPECT_TRUE(_receiver->info().outputs.empty());
+    EXPECT_FALSE(_sender->pollHandle(PollEvents::in));
+    EXPECT_TRUE(_receiver->pollHandle(PollEvents::in));
+}
+
+TEST_F(JackClient, send_and_receive)
+{
+    EXPECT_FALSE(_sender->postEvent(events::NoteOn{9, 36, 100}));
+    // Not transported
+    EXPECT_FALSE(_sender->postEvent(events::Start{}));
+    EXPECT_FALSE(_sender->postEvent(
+        events::Controller{.channel = 1, .value = 127, .parameter = 64}));
+
+    const auto received = receive(2);
+    ASSERT_EQ(received.size(), 2);
+    const auto& noteOn = std::get<events::NoteOn>(received[0]);
+    EXPECT_EQ(noteOn.channel, 9);
+    EXPECT_EQ(noteOn.note, 36);
+    EXPECT_EQ(noteOn.velocity, 100);
+    const auto& controller = std::get<events::Controller>(received[1]);
+    EXPECT_EQ(controller.channel, 1);
+    EXPECT_EQ(controller.parameter, 64);
+    EXPECT_EQ(controller.value, 127);
+}
+
+TEST_F(JackClient, order_is_preserved)
+{
+    for (Value7bit note = 0; note != 100; ++note)
+        ASSERT_FALSE(_sender->postEvent(events::NoteOn{0, note, 1}));
+
+    const auto received = receive(100);
+    ASSERT_EQ(received.size(), 100);
+    for (size_t i = 0; i != received.size(); ++i)
+        EXPECT_EQ(std::get<events::NoteOn>(received[i]).note, i);
+}
+
+// Also requires a padKONTROL, which the JACK engine finds through ALSA.
+TEST(JackEngine, open_pad)
+{
+    auto engine = Engine::create(EngineBackend::jack);
+    if (!engine)
+        GTEST_SKIP() << engine.error().message();
+    const auto infos = engine->queryClientInfos();
+    const auto device =
+        std::find_if(infos.begin(), infos.end(), &KorgPadKontrol::matches);
+    if (device == infos.end())
+        GTEST_SKIP() << "No padKONTROL found";
+
+    // The device replies are read through raw MIDI, so the handshake
+    // succeeds.
+    auto pad = KorgPadKontrol::open(&*engine, *device, "paddock-test");
+    ASSERT_TRUE(pad) << pad.error().message();
+    EXPECT_EQ(pad->mode(), KorgPadKontrol::Mode::native);
+    EXPECT_FALSE(pad->identity().empty());
+
+    EXPECT_EQ(pad->setMode(KorgPadKontrol::Mode::normal),
+              KorgPadKontrol::Error::unsupportedMode);
+    EXPECT_EQ(pad->mode(), KorgPadKontrol::Mode::native);
+}
+
+} // namespace paddock
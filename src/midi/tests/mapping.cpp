@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include "midi/Mapping.hpp"
+
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi;
+using Rule = Mapping::Rule;
+
+std::vector<events::Event> apply(const Mapping& mapping,
+                                 const events::Event& event)
+{
+    std::vector<events::Event> result;
+    mapping.apply(event,
+                  [&result](const events::Event& e) { result.push_back(e); });
+    return result;
+}
+
+template <typename T>
+const T& get(const std::vector<events::Event>& events, size_t index)
+{
+    EXPECT_LT(index, events.size());
+    EXPECT_TRUE(std::holds_alternative<T>(events[index]));
+    return std::get<T>(events[index]);
+}
+} // namespace
+
+TEST(Mapping, empty_mapping_passes_all_events)
+{
+    const Mapping mapping;
+    const auto output = apply(mapping, events::NoteOn{3, 60, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 60);
+}
+
+TEST(Mapping, invalid_rules)
+{
+    Rule rule;
+    rule.channel = 16;
+    EXPECT_FALSE(Mapping::compile({rule}));
+
+    rule = Rule{};
+    rule.low = 70;
+    rule.high = 60;
+    EXPECT_FALSE(Mapping::compile({rule}));
+
+    rule = Rule{};
+    rule.valueScale = -1;
+    EXPECT_FALSE(Mapping::compile({rule}));
+}
+
+TEST(Mapping, unmatched_events_pass_through)
+{
+    Rule rule;
+    rule.channel = 0;
+    rule.outputChannel = 9;
+    const auto mapping = Mapping::compile({rule});
+    ASSERT_TRUE(mapping);
+
+    auto output = apply(*mapping, events::NoteOn{1, 60, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).channel, 1);
+
+    output = apply(*mapping, events::Controller{0, 10, 7});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::Controller>(output, 0).channel, 0);
+
+    output = apply(*mapping, events::PitchBend{0, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::PitchBend>(output, 0).value, 100);
+}
+
+TEST(Mapping, channel_remap)
+{
+    Rule rule;
+    rule.channel = 0;
+    rule.outputChannel = 9;
+    const auto mapping = Mapping::compile({rule});
+    ASSERT_TRUE(mapping);
+
+    auto output = apply(*mapping, events::NoteOn{0, 60, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).channel, 9);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 60);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).velocity, 100);
+
+    output = apply(*mapping, events::NoteOff{0, 60, 0});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOff>(output, 0).channel, 9);
+}
+
+TEST(Mapping, controller_remap)
+{
+    Rule rule;
+    rule.kind = Mapping::Kind::controller;
+    rule.low = rule.high = 1;
+    rule.outputNumber = 11;
+    const auto mapping = Mapping::compile({rule});
+    ASSERT_TRUE(mapping);
+
+    auto output = apply(*mapping, events::Controller{2, 64, 1});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::Controller>(output, 0).parameter, 11);
+    EXPECT_EQ(get<events::Controller>(output, 0).value, 64);
+
+    // Notes with the same number aren't affected.
+    output = apply(*mapping, events::NoteOn{2, 1, 64});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 1);
+}
+
+TEST(Mapping, split)
+{
+    Rule lower;
+    lower.high = 59;
+    lower.outputChannel = 1;
+    lower.transpose = 12;
+    Rule upper;
+    upper.low = 60;
+    upper.outputChannel = 2;
+    const auto mapping = Mapping::compile({lower, upper});
+    ASSERT_TRUE(mapping);
+
+    auto output = apply(*mapping, events::NoteOn{0, 59, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).channel, 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 71);
+
+    output = apply(*mapping, events::NoteOn{0, 60, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).channel, 2);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 60);
+}
+
+TEST(Mapping, layers)
+{
+    Rule first;
+    first.outputChannel = 1;
+    Rule second;
+    second.outputChannel = 2;
+    second.transpose = -12;
+    second.valueScale = 50;
+    const auto mapping = Mapping::compile({first, second});
+    ASSERT_TRUE(mapping);
+
+    const auto output = apply(*mapping, events::NoteOn{0, 60, 100});
+    ASSERT_EQ(output.size(), 2);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).channel, 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 60);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).velocity, 100);
+    EXPECT_EQ(get<events::NoteOn>(output, 1).channel, 2);
+    EXPECT_EQ(get<events::NoteOn>(output, 1).note, 48);
+    EXPECT_EQ(get<events::NoteOn>(output, 1).velocity, 50);
+}
+
+TEST(Mapping, velocity_scale)
+{
+    Rule rule;
+    rule.valueScale = 200;
+    auto mapping = Mapping::compile({rule});
+    ASSERT_TRUE(mapping);
+
+    auto output = apply(*mapping, events::NoteOn{0, 60, 100});
+    EXPECT_EQ(get<events::NoteOn>(output, 0).velocity, 127);
+
+    rule.valueScale = 0;
+    mapping = Mapping::compile({rule});
+    ASSERT_TRUE(mapping);
+
+    // Note ons must not become note offs.
+    output = apply(*mapping, events::NoteOn{0, 60, 100});
+    EXPECT_EQ(get<events::NoteOn>(output, 0).velocity, 1);
+}
+
+TEST(Mapping, mute_and_out_of_range)
+{
+    Rule muted;
+    muted.low = muted.high = 36;
+    muted.mute = true;
+    Rule transposed;
+    transposed.low = 110;
+    transposed.transpose = 10;
+    const auto mapping = Mapping::compile({muted, transposed});
+    ASSERT_TRUE(mapping);
+
+    EXPECT_TRUE(apply(*mapping, events::NoteOn{0, 36, 100}).empty());
+    EXPECT_TRUE(apply(*mapping, events::NoteOn{0, 120, 100}).empty());
+
+    const auto output = apply(*mapping, events::NoteOn{0, 117, 100});
+    ASSERT_EQ(output.size(), 1);
+    EXPECT_EQ(get<events::NoteOn>(output, 0).note, 127);
+}
+
+} // namespace paddock
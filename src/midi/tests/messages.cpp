@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "midi/messages.hpp"
+
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi;
+
+std::vector<uint8_t> encode(const events::Event& event)
+{
+    const auto message = encodeShortMessage(event);
+    if (!message)
+        return {};
+    return std::vector<uint8_t>(message->data.begin(),
+                                message->data.begin() + message->size);
+}
+} // namespace
+
+TEST(ShortMessage, encode)
+{
+    EXPECT_EQ(encode(events::NoteOn{9, 36, 100}),
+              std::vector<uint8_t>({0x99, 36, 100}));
+    EXPECT_EQ(encode(events::NoteOff{0, 36, 0}),
+              std::vector<uint8_t>({0x80, 36, 0}));
+    EXPECT_EQ(encode(events::Controller{
+                  .channel = 1, .value = 127, .parameter = 64}),
+              std::vector<uint8_t>({0xB1, 64, 127}));
+    EXPECT_EQ(encode(events::ProgramChange{2, 5}),
+              std::vector<uint8_t>({0xC2, 5}));
+    EXPECT_EQ(encode(events::PitchBend{0, 0}),
+              std::vector<uint8_t>({0xE0, 0x00, 0x40}));
+    EXPECT_EQ(encode(events::PitchBend{0, -8192}),
+              std::vector<uint8_t>({0xE0, 0x00, 0x00}));
+    EXPECT_TRUE(encode(events::Start{}).empty());
+}
+
+TEST(ShortMessage, round_trip)
+{
+    const std::vector<events::Event> events{
+        events::NoteOn{15, 127, 1},
+        events::NoteOff{3, 0, 64},
+        events::KeyPressure{4, 60, 10},
+        events::Controller{.channel = 5, .value = 3, .parameter = 7},
+        events::ProgramChange{6, 100},
+        events::ChannelPressure{7, 90},
+        events::PitchBend{8, 8191},
+        events::PitchBend{8, -8192}};
+
+    for (const auto& event : events)
+    {
+        const auto message = encodeShortMessage(event);
+        ASSERT_TRUE(message);
+        const auto decoded = decodeShortMessage(
+            std::span{message->data.data(), message->size});
+        ASSERT_TRUE(decoded);
+        EXPECT_EQ(encode(*decoded), encode(event));
+        EXPECT_EQ(decoded->index(), event.index());
+    }
+}
+
+TEST(ShortMessage, decode_invalid)
+{
+    const std::vector<uint8_t> runningStatus{36, 100};
+    EXPECT_FALSE(decodeShortMessage(runningStatus));
+    const std::vector<uint8_t> truncated{0x90, 36};
+    EXPECT_FALSE(decodeShortMessage(truncated));
+    const std::vector<uint8_t> activeSensing{0xFE};
+    EXPECT_FALSE(decodeShortMessage(activeSensing));
+    const std::vector<uint8_t> truncatedPosition{0xF2, 0x10};
+    EXPECT_FALSE(decodeShortMessage(truncatedPosition));
+    EXPECT_FALSE(decodeShortMessage({}));
+}
+
+TEST(ShortMessage, decode_clock)
+{
+    const std::vector<uint8_t> clock{0xF8};
+    EXPECT_TRUE(std::holds_alternative<events::Clock>(
+        decodeShortMessage(clock).value()));
+    const std::vector<uint8_t> start{0xFA};
+    EXPECT_TRUE(std::holds_alternative<events::Start>(
+        decodeShortMessage(start).value()));
+    const std::vector<uint8_t> stop{0xFC};
+    EXPECT_TRUE(std::holds_alternative<events::Stop>(
+        decodeShortMessage(stop).value()));
+
+    const std::vector<uint8_t> position{0xF2, 0x10, 0x01};
+    const auto decoded = decodeShortMessage(position);
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(std::get<events::SongPosition>(*decoded).beats, 0x90);
+    // Only the voice messages are encoded
+    EXPECT_FALSE(encodeShortMessage(events::Clock{}));
+}
+
+} // namespace paddock
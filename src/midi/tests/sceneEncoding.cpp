@@ -254,4 +254,80 @@ TEST(korgPadKontrolEncoding, repeaters)
     ASSERT_EQ(scene->roll, testScene.roll);
 }
 
+TEST(korgPadKontrolEncoding, scene)
+{
+    auto payload = encodeScene(testScene);
+    ASSERT_TRUE(payload);
+    auto scene = decodeScene(*payload);
+    ASSERT_TRUE(scene);
+    ASSERT_TRUE(*scene == testScene);
+}
+
+TEST(korgPadKontrolEncoding, axisReleaseValues)
+{
+    auto input = testScene;
+    input.x.releaseValue = 100;
+    input.y.type = Scene::KnobType::PitchBend;
+    input.y.releaseValue = -100;
+
+    auto payload = encodeScene(input);
+    ASSERT_TRUE(payload);
+    for (auto byte : *payload)
+        ASSERT_EQ(byte & 0x80_b, 0x00_b);
+    auto scene = decodeScene(*payload);
+    ASSERT_TRUE(scene);
+    ASSERT_EQ(scene->x, input.x);
+    ASSERT_EQ(scene->y, input.y);
+}
+
+TEST(korgPadKontrolEncoding, validation)
+{
+    ASSERT_FALSE(validateScene(testScene));
+
+    auto scene = testScene;
+    scene.pedal.action =
+        Scene::Note{.note = 0, .velocity = Scene::Note::VelocityCurve::curve1};
+    ASSERT_TRUE(validateScene(scene));
+    ASSERT_FALSE(encodeScene(scene));
+
+    scene = testScene;
+    scene.pads[0].action = Scene::Note{
+        .note = 128, .velocity = Scene::Note::VelocityCurve::curve1};
+    ASSERT_TRUE(validateScene(scene));
+
+    scene = testScene;
+    scene.pads[3].midiChannel = 17;
+    ASSERT_TRUE(validateScene(scene));
+
+    scene = testScene;
+    scene.roll.minSpeed = 39;
+    ASSERT_TRUE(validateScene(scene));
+
+    scene = testScene;
+    scene.knobs[1].param = 128;
+    ASSERT_TRUE(validateScene(scene));
+}
+
+TEST(korgPadKontrolEncoding, diff)
+{
+    ASSERT_TRUE(diffScenes(testScene, testScene).none());
+
+    auto scene = testScene;
+    scene.pads[3].port = Scene::Port::A;
+    scene.y.releaseValue = 0;
+
+    const auto diff = diffScenes(testScene, scene);
+    ASSERT_EQ(diff.count(), 2);
+
+    std::vector<ScenePath> paths;
+    for (size_t i = 0; i != diff.size(); ++i)
+    {
+        if (diff[i])
+            paths.push_back(sceneFieldPaths()[i]);
+    }
+    ASSERT_EQ(paths[0], (ScenePath{SceneSection::pad, 3, SceneField::port}));
+    ASSERT_EQ(paths[1],
+              (ScenePath{SceneSection::axis, 1, SceneField::releaseValue}));
+}
+
 } // namespace paddock
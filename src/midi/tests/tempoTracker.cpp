@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include "midi/TempoTracker.hpp"
+
+#include <cmath>
+
+namespace paddock
+{
+namespace
+{
+using namespace midi;
+using namespace std::chrono_literals;
+using Clock = TempoTracker::Clock;
+
+Clock::duration tickPeriod(double beatsPerMinute)
+{
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(
+            60 / beatsPerMinute / TempoTracker::ticksPerQuarterNote));
+}
+} // namespace
+
+TEST(TempoTracker, steady_clock)
+{
+    TempoTracker tracker;
+    EXPECT_EQ(tracker.state().beatsPerMinute, 0);
+
+    auto time = Clock::time_point{} + 1h;
+    EXPECT_TRUE(tracker.process(events::Start{}, time));
+    for (int i = 0; i != 48; ++i)
+    {
+        EXPECT_TRUE(tracker.process(events::Clock{}, time));
+        time += tickPeriod(120);
+    }
+
+    const auto state = tracker.state();
+    EXPECT_TRUE(state.running);
+    EXPECT_NEAR(state.beatsPerMinute, 120, 0.01);
+    // The last tick received is the 48th
+    EXPECT_NEAR(state.position, 47.0 / 24, 1e-9);
+    EXPECT_NEAR(state.positionAt(state.time + 250ms), 47.0 / 24 + 0.5, 1e-3);
+    EXPECT_NEAR(state.phaseAt(state.time + tickPeriod(120)), 0, 1e-3);
+}
+
+TEST(TempoTracker, jitter_is_filtered)
+{
+    TempoTracker tracker;
+    auto time = Clock::time_point{} + 1h;
+    // +-2 ms of jitter on a 100 bpm clock (25 ms per tick)
+    for (int i = 0; i != 24 * 16; ++i)
+    {
+        const auto jitter = std::chrono::milliseconds{(i % 3 - 1) * 2};
+        tracker.process(events::Clock{}, time + jitter);
+        time += tickPeriod(100);
+    }
+    EXPECT_NEAR(tracker.state().beatsPerMinute, 100, 1);
+}
+
+TEST(TempoTracker, follows_tempo_changes)
+{
+    TempoTracker tracker;
+    auto time = Clock::time_point{} + 1h;
+    for (int i = 0; i != 24 * 4; ++i)
+    {
+        tracker.process(events::Clock{}, time);
+        time += tickPeriod(90);
+    }
+    EXPECT_NEAR(tracker.state().beatsPerMinute, 90, 0.5);
+
+    // A few seconds at the new tempo
+    for (int i = 0; i != 24 * 8; ++i)
+    {
+        tracker.process(events::Clock{}, time);
+        time += tickPeriod(140);
+    }
+    EXPECT_NEAR(tracker.state().beatsPerMinute, 140, 0.5);
+}
+
+TEST(TempoTracker, transport)
+{
+    TempoTracker tracker;
+    auto time = Clock::time_point{} + 1h;
+
+    // Clock without Start moves the tempo but not the position
+    for (int i = 0; i != 4; ++i)
+    {
+        tracker.process(events::Clock{}, time);
+        time += tickPeriod(120);
+    }
+    EXPECT_FALSE(tracker.state().running);
+    EXPECT_EQ(tracker.state().position, 0);
+    EXPECT_GT(tracker.state().beatsPerMinute, 0);
+
+    // 8 MIDI beats = 2 quarter notes
+    EXPECT_TRUE(tracker.process(events::SongPosition{8}, time));
+    EXPECT_EQ(tracker.state().position, 2);
+    EXPECT_TRUE(tracker.process(events::Continue{}, time));
+    tracker.process(events::Clock{}, time);
+    time += tickPeriod(120);
+    tracker.process(events::Clock{}, time);
+    EXPECT_NEAR(tracker.state().position, 2 + 1.0 / 24, 1e-9);
+
+    EXPECT_TRUE(tracker.process(events::Stop{}, time));
+    const auto state = tracker.state();
+    EXPECT_FALSE(state.running);
+    EXPECT_EQ(state.positionAt(state.time + 1s), state.position);
+
+    EXPECT_FALSE(tracker.process(events::NoteOn{0, 60, 100}, time));
+}
+
+TEST(TempoTracker, restarts_after_a_gap)
+{
+    TempoTracker tracker;
+    auto time = Clock::time_point{} + 1h;
+    for (int i = 0; i != 24; ++i)
+    {
+        tracker.process(events::Clock{}, time);
+        time += tickPeriod(120);
+    }
+    time += 10s;
+    tracker.process(events::Clock{}, time);
+    EXPECT_EQ(tracker.state().beatsPerMinute, 0);
+    time += tickPeriod(60);
+    tracker.process(events::Clock{}, time);
+    EXPECT_NEAR(tracker.state().beatsPerMinute, 60, 0.01);
+}
+
+} // namespace paddock
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <memory>
+#include <cstdint>
 
 namespace paddock::midi
 {
@@ -8,6 +8,18 @@ using Value7bit = unsigned char;
 using Value14bit = short;
 using UValue14bit = unsigned short;
 
-using ClientId = std::shared_ptr<void>;
+/// A client interned by the engine, see ClientTable.
+struct ClientId
+{
+    static constexpr uint32_t invalidIndex = ~uint32_t{0};
+
+    /// The slot of the client in the engine, its native number in ALSA.
+    uint32_t index{invalidIndex};
+    /// Tells apart the clients that used the same slot over time.
+    uint32_t generation{0};
+
+    explicit operator bool() const { return index != invalidIndex; }
+    bool operator==(const ClientId& other) const = default;
+};
 
 } // namespace paddock::midi
@@ -4,6 +4,7 @@ import Paddock 1.0
 PadUi.Controller {
     property KorgPadKontrol controller: null
     program: controller.program
+    tempo: controller !== null ? controller.tempo : 0
 
     enabled: controller !== null && controller.isConnected
 
@@ -9,6 +9,8 @@ ColumnLayout {
     id: root
 
     property Program program
+    // Of the MIDI clock received, 0 without clock
+    property real tempo: 0
 
     Rectangle {
         id: header
@@ -31,6 +33,16 @@ ColumnLayout {
             font.pointSize: Styling.sizes.fonts.title
             color: "#FFFFFF"
         }
+
+        Text {
+            anchors.verticalCenter: headerText.verticalCenter
+            anchors.right: parent.right
+            anchors.rightMargin: Styling.sizes.spacings.min
+            visible: root.tempo > 0
+            text: root.tempo.toFixed(1) + " BPM"
+            font.pointSize: Styling.sizes.fonts.title
+            color: "#FFFFFF"
+        }
     }
 
     Item {
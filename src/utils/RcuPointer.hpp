@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace paddock
+{
+/// A pointer to an immutable object that is read from one or more threads
+/// and replaced from others, RCU style.
+///
+/// Readers never block nor allocate: taking a read guard increments the
+/// reader counter of the current grace period and loads the pointer. Writers
+/// publish a new object and reclaim the old one once all the readers that
+/// may still see it are gone. Writers are serialized between them.
+///
+/// Read guards must be short lived, as writers spin until they are released.
+template <typename T>
+class RcuPointer
+{
+public:
+    class ReadGuard
+    {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() { _readers->fetch_sub(1, std::memory_order_release); }
+
+        const T* get() const { return _object; }
+        const T* operator->() const { return _object; }
+        const T& operator*() const { return *_object; }
+        explicit operator bool() const { return _object != nullptr; }
+
+    private:
+        friend class RcuPointer;
+
+        ReadGuard(std::atomic<size_t>* readers, const T* object)
+            : _readers{readers}
+            , _object{object}
+        {
+        }
+
+        std::atomic<size_t>* _readers;
+        const T* _object;
+    };
+
+    RcuPointer() = default;
+
+    explicit RcuPointer(std::unique_ptr<const T> object)
+        : _object{object.release()}
+    {
+    }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /// No reader can be active during destruction.
+    ~RcuPointer() { delete _object.load(std::memory_order_relaxed); }
+
+    /// Wait-free
+    ReadGuard read() const
+    {
+        auto& readers = _readers[_period.load() & 1];
+        readers.fetch_add(1);
+        // Sequentially consistent so that a writer either sees the counter
+        // incremented or this load sees the new object.
+        return ReadGuard{&readers, _object.load()};
+    }
+
+    /// Replaces the object and destroys the previous one after the grace
+    /// period.
+    void publish(std::unique_ptr<const T> object)
+    {
+        std::unique_ptr<const T> old;
+        {
+            std::lock_guard<std::mutex> lock(_writerMutex);
+            old.reset(_object.exchange(object.release()));
+            // Readers that arrive from now on see the new object, but the
+            // ones holding the old object may be counted in any of the two
+            // periods (a reader may have loaded the period before a previous
+            // flip). Flipping twice and waiting for the period that is no
+            // longer current each time drains both counters without starving
+            // on new readers.
+            for (int i = 0; i != 2; ++i)
+            {
+                const auto period = _period.fetch_add(1);
+                _waitForReaders(_readers[period & 1]);
+            }
+        }
+    }
+
+    /// Reads the object from a writer thread.
+    /// @warning The pointer is only valid until the next publish.
+    const T* unsafeGet() const
+    {
+        return _object.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<const T*> _object{nullptr};
+    std::atomic<size_t> _period{0};
+    mutable std::array<std::atomic<size_t>, 2> _readers{};
+    std::mutex _writerMutex;
+
+    static void _waitForReaders(const std::atomic<size_t>& readers)
+    {
+        while (readers.load() != 0)
+            std::this_thread::yield();
+    }
+};
+
+} // namespace paddock
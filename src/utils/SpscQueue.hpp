@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <vector>
+
+namespace paddock
+{
+/// A bounded queue between one producer thread and one consumer thread.
+///
+/// The storage is allocated on construction, push and pop never allocate nor
+/// block, which makes the queue suitable to hand data from a real-time thread
+/// to a background one. T must be default constructible, the slots are
+/// overwritten on push.
+template <typename T>
+class SpscQueue
+{
+public:
+    /// The capacity is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity)
+        : _slots(_roundUp(capacity))
+        , _mask{_slots.size() - 1}
+    {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return _slots.size(); }
+
+    /// Producer side
+    /// @return false if the queue is full
+    bool push(const T& value)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead == _slots.size())
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead == _slots.size())
+                return false;
+        }
+        _slots[tail & _mask] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side
+    std::optional<T> pop()
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail)
+                return std::nullopt;
+        }
+        std::optional<T> value{std::move(_slots[head & _mask])};
+        _head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+private:
+    // Keeps the indices of each side in its own cache line.
+    static constexpr size_t _cacheLineSize = 64;
+
+    std::vector<T> _slots;
+    size_t _mask;
+
+    alignas(_cacheLineSize) std::atomic<size_t> _head{0};
+    size_t _cachedTail{0}; // Consumer copy of _tail
+
+    alignas(_cacheLineSize) std::atomic<size_t> _tail{0};
+    size_t _cachedHead{0}; // Producer copy of _head
+
+    static size_t _roundUp(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        return size;
+    }
+};
+
+} // namespace paddock
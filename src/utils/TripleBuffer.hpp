@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace paddock
+{
+/// Hands the latest value of something from one producer thread to one
+/// consumer thread.
+///
+/// Each side owns one slot and the third one is exchanged through an atomic
+/// index, so writing and reading never block, allocate nor retry. Values
+/// written while the consumer isn't looking are overwritten, only the latest
+/// one is seen. T must be default constructible and copy assignable.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    explicit TripleBuffer(const T& initial)
+        : _slots{initial, initial, initial}
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /// Producer side
+    void write(const T& value)
+    {
+        _slots[_back] = value;
+        _back = _middle.exchange(_back | _fresh, std::memory_order_acq_rel) &
+                _indexMask;
+    }
+
+    /// Consumer side
+    /// @return the last value written, or the initial one if none was
+    const T& read()
+    {
+        if (_middle.load(std::memory_order_relaxed) & _fresh)
+        {
+            _front = _middle.exchange(_front, std::memory_order_acq_rel) &
+                     _indexMask;
+        }
+        return _slots[_front];
+    }
+
+private:
+    static constexpr uint8_t _indexMask = 0x03;
+    // Set in the middle index when it holds a value the consumer hasn't read.
+    static constexpr uint8_t _fresh = 0x04;
+
+    std::array<T, 3> _slots{};
+    std::atomic<uint8_t> _middle{1};
+    uint8_t _back{0};  // Producer slot
+    uint8_t _front{2}; // Consumer slot
+};
+
+} // namespace paddock
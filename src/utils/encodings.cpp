@@ -1,65 +1,420 @@
 #include "encodings.hpp"
 
-#include "byte.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PADDOCK_X86_ENCODING_KERNELS 1
+#include <immintrin.h>
+#endif
 
 namespace paddock
 {
 namespace
 {
-void merge(std::byte& byte, unsigned char mask)
+constexpr size_t decodedGroupSize = 7;
+constexpr size_t encodedGroupSize = 8;
+
+// A group of 7 bytes is a big endian 56-bit integer. Encoding spreads its
+// 7-bit fields into the bytes of a 64-bit integer and decoding gathers them
+// back. Both are done in three branch free steps (28, 14 and 7 bits).
+
+uint64_t spread7to8(uint64_t value)
 {
-    byte = static_cast<std::byte>(static_cast<unsigned char>(byte) | mask);
+    value = (value & 0x000000000FFFFFFF) |
+            ((value << 4) & 0x0FFFFFFF00000000);
+    value = (value & 0x00003FFF00003FFF) |
+            ((value << 2) & 0x3FFF00003FFF0000);
+    return (value & 0x007F007F007F007F) | ((value << 1) & 0x7F007F007F007F00);
 }
-} // namespace
 
-std::vector<std::byte> to7bitEncoding(std::span<const std::byte> input)
+uint64_t gather8to7(uint64_t value)
 {
-    std::vector<std::byte> result((input.size() * 8 + 6) / 7, 0x00_b);
+    value = (value & 0x007F007F007F007F) |
+            ((value >> 1) & 0x3F803F803F803F80);
+    value = (value & 0x00003FFF00003FFF) |
+            ((value >> 2) & 0x0FFFC0000FFFC000);
+    return (value & 0x000000000FFFFFFF) |
+           ((value >> 4) & 0x00FFFFFFF0000000);
+}
 
-    auto in = input.begin();
-    auto out = result.begin();
+void encodeGroup(const std::byte* in, std::byte* out)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i != decodedGroupSize; ++i)
+        value = (value << 8) | uint64_t(in[i]);
+    value = spread7to8(value);
+    for (size_t i = 0; i != encodedGroupSize; ++i)
+        out[i] = std::byte(value >> (8 * (encodedGroupSize - 1 - i)));
+}
+
+void decodeGroup(const std::byte* in, std::byte* out)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i != encodedGroupSize; ++i)
+        value = (value << 8) | (uint64_t(in[i]) & 0x7F);
+    value = gather8to7(value);
+    for (size_t i = 0; i != decodedGroupSize; ++i)
+        out[i] = std::byte(value >> (8 * (decodedGroupSize - 1 - i)));
+}
+
+// Vectorized kernels process as many groups as they can without reading or
+// writing out of the given ranges, advancing the pointers. The remaining
+// groups are handled by the scalar code.
+using Kernel = void (*)(const std::byte*& in, const std::byte* inEnd,
+                        std::byte*& out, std::byte* outEnd);
+
+void noKernel(const std::byte*&, const std::byte*, std::byte*&, std::byte*)
+{
+}
+
+#ifdef PADDOCK_X86_ENCODING_KERNELS
+
+// Shuffle masks per 128-bit lane (two groups per lane).
+
+// 14 input bytes to two 64-bit integers, one per group.
+#define PADDOCK_LOAD_DECODED \
+    6, 5, 4, 3, 2, 1, 0, -1, 13, 12, 11, 10, 9, 8, 7, -1
+// 64-bit byte swap.
+#define PADDOCK_SWAP_BYTES 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+// Two 56-bit integers to 14 output bytes.
+#define PADDOCK_STORE_DECODED \
+    6, 5, 4, 3, 2, 1, 0, 14, 13, 12, 11, 10, 9, 8, -1, -1
+
+__attribute__((target("ssse3"))) __m128i merge(__m128i low, __m128i high,
+                                                int64_t lowMask,
+                                                int64_t highMask)
+{
+    return _mm_or_si128(_mm_and_si128(low, _mm_set1_epi64x(lowMask)),
+                        _mm_and_si128(high, _mm_set1_epi64x(highMask)));
+}
+
+__attribute__((target("ssse3"))) __m128i spread7to8(__m128i value)
+{
+    value = merge(value, _mm_slli_epi64(value, 4), 0x000000000FFFFFFF,
+                  0x0FFFFFFF00000000);
+    value = merge(value, _mm_slli_epi64(value, 2), 0x00003FFF00003FFF,
+                  0x3FFF00003FFF0000);
+    return merge(value, _mm_slli_epi64(value, 1), 0x007F007F007F007F,
+                 0x7F007F007F007F00);
+}
+
+__attribute__((target("ssse3"))) __m128i gather8to7(__m128i value)
+{
+    value = merge(value, _mm_srli_epi64(value, 1), 0x007F007F007F007F,
+                  0x3F803F803F803F80);
+    value = merge(value, _mm_srli_epi64(value, 2), 0x00003FFF00003FFF,
+                  0x0FFFC0000FFFC000);
+    return merge(value, _mm_srli_epi64(value, 4), 0x000000000FFFFFFF,
+                 0x00FFFFFFF0000000);
+}
+
+__attribute__((target("ssse3"))) void encodeSsse3(const std::byte*& in,
+                                                  const std::byte* inEnd,
+                                                  std::byte*& out,
+                                                  std::byte* outEnd)
+{
+    const auto load = _mm_setr_epi8(PADDOCK_LOAD_DECODED);
+    const auto store = _mm_setr_epi8(PADDOCK_SWAP_BYTES);
 
-    while (in != input.end())
+    // Reads 16 bytes to encode 14.
+    while (inEnd - in >= 16 && outEnd - out >= 16)
     {
-        for (int i = 1; i != 8; ++i, ++in)
-        {
-            if (in == input.end())
-                return result;
+        auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        value = spread7to8(_mm_shuffle_epi8(value, load));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm_shuffle_epi8(value, store));
+        in += 2 * decodedGroupSize;
+        out += 2 * encodedGroupSize;
+    }
+}
 
-            const auto byte = static_cast<unsigned char>(*in);
-            merge(*out++, byte >> i);
-            merge(*out, (byte << (7 - i)) & '\x7F');
-        }
-        ++out;
+__attribute__((target("ssse3"))) void decodeSsse3(const std::byte*& in,
+                                                  const std::byte* inEnd,
+                                                  std::byte*& out,
+                                                  std::byte* outEnd)
+{
+    const auto load = _mm_setr_epi8(PADDOCK_SWAP_BYTES);
+    const auto store = _mm_setr_epi8(PADDOCK_STORE_DECODED);
+    const auto mask = _mm_set1_epi8(0x7F);
+
+    // Writes 16 bytes to decode 14.
+    while (inEnd - in >= 16 && outEnd - out >= 16)
+    {
+        auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        value = _mm_and_si128(_mm_shuffle_epi8(value, load), mask);
+        value = gather8to7(value);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm_shuffle_epi8(value, store));
+        in += 2 * encodedGroupSize;
+        out += 2 * decodedGroupSize;
+    }
+}
+
+__attribute__((target("avx2"))) __m256i merge(__m256i low, __m256i high,
+                                               int64_t lowMask,
+                                               int64_t highMask)
+{
+    return _mm256_or_si256(_mm256_and_si256(low, _mm256_set1_epi64x(lowMask)),
+                           _mm256_and_si256(high,
+                                            _mm256_set1_epi64x(highMask)));
+}
+
+__attribute__((target("avx2"))) __m256i spread7to8(__m256i value)
+{
+    value = merge(value, _mm256_slli_epi64(value, 4), 0x000000000FFFFFFF,
+                  0x0FFFFFFF00000000);
+    value = merge(value, _mm256_slli_epi64(value, 2), 0x00003FFF00003FFF,
+                  0x3FFF00003FFF0000);
+    return merge(value, _mm256_slli_epi64(value, 1), 0x007F007F007F007F,
+                 0x7F007F007F007F00);
+}
+
+__attribute__((target("avx2"))) __m256i gather8to7(__m256i value)
+{
+    value = merge(value, _mm256_srli_epi64(value, 1), 0x007F007F007F007F,
+                  0x3F803F803F803F80);
+    value = merge(value, _mm256_srli_epi64(value, 2), 0x00003FFF00003FFF,
+                  0x0FFFC0000FFFC000);
+    return merge(value, _mm256_srli_epi64(value, 4), 0x000000000FFFFFFF,
+                 0x00FFFFFFF0000000);
+}
+
+__attribute__((target("avx2"))) void encodeAvx2(const std::byte*& in,
+                                                const std::byte* inEnd,
+                                                std::byte*& out,
+                                                std::byte* outEnd)
+{
+    const auto load = _mm256_setr_epi8(PADDOCK_LOAD_DECODED,
+                                       PADDOCK_LOAD_DECODED);
+    const auto store = _mm256_setr_epi8(PADDOCK_SWAP_BYTES,
+                                        PADDOCK_SWAP_BYTES);
+
+    // Reads 30 bytes (two overlapping 16 byte loads) to encode 28.
+    while (inEnd - in >= 30 && outEnd - out >= 32)
+    {
+        auto value = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                in + 2 * decodedGroupSize)),
+            1);
+        value = spread7to8(_mm256_shuffle_epi8(value, load));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                            _mm256_shuffle_epi8(value, store));
+        in += 4 * decodedGroupSize;
+        out += 4 * encodedGroupSize;
+    }
+    encodeSsse3(in, inEnd, out, outEnd);
+}
+
+__attribute__((target("avx2"))) void decodeAvx2(const std::byte*& in,
+                                                const std::byte* inEnd,
+                                                std::byte*& out,
+                                                std::byte* outEnd)
+{
+    const auto load = _mm256_setr_epi8(PADDOCK_SWAP_BYTES, PADDOCK_SWAP_BYTES);
+    const auto store = _mm256_setr_epi8(PADDOCK_STORE_DECODED,
+                                        PADDOCK_STORE_DECODED);
+    const auto mask = _mm256_set1_epi8(0x7F);
+
+    // Writes 30 bytes (two overlapping 16 byte stores) to decode 28.
+    while (inEnd - in >= 32 && outEnd - out >= 30)
+    {
+        auto value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+        value = _mm256_and_si256(_mm256_shuffle_epi8(value, load), mask);
+        value = _mm256_shuffle_epi8(gather8to7(value), store);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm256_castsi256_si128(value));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out + 2 * decodedGroupSize),
+            _mm256_extracti128_si256(value, 1));
+        in += 4 * encodedGroupSize;
+        out += 4 * decodedGroupSize;
     }
+    decodeSsse3(in, inEnd, out, outEnd);
+}
+
+#undef PADDOCK_LOAD_DECODED
+#undef PADDOCK_SWAP_BYTES
+#undef PADDOCK_STORE_DECODED
+
+#endif
+
+struct Kernels
+{
+    Kernel encode;
+    Kernel decode;
+};
+
+Kernels selectKernels()
+{
+#ifdef PADDOCK_X86_ENCODING_KERNELS
+    if (__builtin_cpu_supports("avx2"))
+        return {encodeAvx2, decodeAvx2};
+    if (__builtin_cpu_supports("ssse3"))
+        return {encodeSsse3, decodeSsse3};
+#endif
+    return {noKernel, noKernel};
+}
+
+const Kernels& kernels()
+{
+    static const Kernels kernels = selectKernels();
+    return kernels;
+}
+
+constexpr char base64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr int invalidBase64 = -1;
+
+constexpr auto base64Values = [] {
+    std::array<int, 256> values{};
+    values.fill(invalidBase64);
+    for (int i = 0; i != 64; ++i)
+        values[static_cast<unsigned char>(base64Alphabet[i])] = i;
+    return values;
+}();
+
+/// The output must be to7bitEncodedSize of the input size.
+void encodeInto(std::span<const std::byte> input, std::span<std::byte> output)
+{
+    auto in = input.data();
+    const auto inEnd = in + input.size();
+    auto out = output.data();
+    const auto outEnd = out + output.size();
+
+    kernels().encode(in, inEnd, out, outEnd);
+
+    for (; inEnd - in >= ptrdiff_t(decodedGroupSize);
+         in += decodedGroupSize, out += encodedGroupSize)
+    {
+        encodeGroup(in, out);
+    }
+
+    if (in != inEnd)
+    {
+        std::byte group[decodedGroupSize]{};
+        std::byte encoded[encodedGroupSize];
+        std::memcpy(group, in, inEnd - in);
+        encodeGroup(group, encoded);
+        std::memcpy(out, encoded, outEnd - out);
+    }
+}
+
+/// The output must be from7bitEncodedSize of the input size.
+void decodeInto(std::span<const std::byte> input, std::span<std::byte> output)
+{
+    auto in = input.data();
+    const auto inEnd = in + input.size();
+    auto out = output.data();
+    const auto outEnd = out + output.size();
+
+    kernels().decode(in, inEnd, out, outEnd);
+
+    for (; inEnd - in >= ptrdiff_t(encodedGroupSize);
+         in += encodedGroupSize, out += decodedGroupSize)
+    {
+        decodeGroup(in, out);
+    }
+
+    if (in != inEnd)
+    {
+        std::byte group[encodedGroupSize]{};
+        std::byte decoded[decodedGroupSize];
+        std::memcpy(group, in, inEnd - in);
+        decodeGroup(group, decoded);
+        std::memcpy(out, decoded, outEnd - out);
+    }
+}
+} // namespace
+
+std::vector<std::byte> to7bitEncoding(std::span<const std::byte> input)
+{
+    std::vector<std::byte> result(to7bitEncodedSize(input.size()));
+    encodeInto(input, result);
     return result;
 }
 
 std::vector<std::byte> from7bitEncoding(std::span<const std::byte> input)
 {
-    std::vector<std::byte> result((input.size() + 1) * 7 / 8, 0x00_b);
+    std::vector<std::byte> result(from7bitEncodedSize(input.size()));
+    decodeInto(input, result);
+    return result;
+}
+
+std::string toBase64(std::span<const std::byte> input)
+{
+    std::string output;
+    output.reserve((input.size() + 2) / 3 * 4);
 
-    auto in = input.begin();
-    auto out = result.begin();
-    while (in != input.end())
+    size_t i = 0;
+    for (; i + 3 <= input.size(); i += 3)
     {
-        *out = static_cast<std::byte>((static_cast<unsigned char>(*in) << 1));
-        ++in;
-        for (int i = 1; i != 7; ++i, ++in)
-        {
-            if (in == input.end())
-                return result;
+        const auto group = (unsigned(input[i]) << 16) |
+                           (unsigned(input[i + 1]) << 8) |
+                           unsigned(input[i + 2]);
+        output += base64Alphabet[group >> 18];
+        output += base64Alphabet[(group >> 12) & 0x3F];
+        output += base64Alphabet[(group >> 6) & 0x3F];
+        output += base64Alphabet[group & 0x3F];
+    }
+
+    if (const auto rest = input.size() - i; rest != 0)
+    {
+        auto group = unsigned(input[i]) << 16;
+        if (rest == 2)
+            group |= unsigned(input[i + 1]) << 8;
+        output += base64Alphabet[group >> 18];
+        output += base64Alphabet[(group >> 12) & 0x3F];
+        output += rest == 2 ? base64Alphabet[(group >> 6) & 0x3F] : '=';
+        output += '=';
+    }
+    return output;
+}
+
+Expected<std::vector<std::byte>> fromBase64(std::string_view input)
+{
+    const auto invalid = tl::make_unexpected(
+        std::make_error_code(std::errc::illegal_byte_sequence));
+
+    if (input.size() % 4 != 0)
+        return invalid;
+
+    size_t padding = 0;
+    if (!input.empty() && input.back() == '=')
+        padding = input[input.size() - 2] == '=' ? 2 : 1;
+
+    std::vector<std::byte> output;
+    output.reserve(input.size() / 4 * 3 - padding);
 
-            const auto byte = static_cast<unsigned char>(*in) & '\x7F';
-            merge(*out++, byte >> (7 - i));
-            merge(*out, byte << (i + 1));
+    for (size_t i = 0; i != input.size(); i += 4)
+    {
+        const bool last = i + 4 == input.size();
+        unsigned group = 0;
+        for (size_t j = 0; j != 4; ++j)
+        {
+            const auto c = static_cast<unsigned char>(input[i + j]);
+            if (last && j >= 4 - padding)
+            {
+                group <<= 6;
+                continue;
+            }
+            const auto value = base64Values[c];
+            if (value == invalidBase64)
+                return invalid;
+            group = (group << 6) | unsigned(value);
         }
-        if (in == input.end())
-            return result;
 
-        merge(*out++, static_cast<unsigned char>(*in++) & '\x7F');
+        output.push_back(std::byte(group >> 16));
+        if (!last || padding < 2)
+            output.push_back(std::byte((group >> 8) & 0xFF));
+        if (!last || padding < 1)
+            output.push_back(std::byte(group & 0xFF));
     }
-    return result;
+    return output;
 }
 
 } // namespace paddock
@@ -1,12 +1,36 @@
 #pragma once
 
+#include "Expected.hpp"
+
 #include <cstddef>
 #include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace paddock
 {
+/// 7-bit encoding of binary data for SysEx messages. The input is treated as
+/// a bit stream (MSB first) that is split into 7-bit groups, so each 7 input
+/// bytes become 8 output bytes. The last group is zero padded.
+
+constexpr size_t to7bitEncodedSize(size_t size)
+{
+    return (size * 8 + 6) / 7;
+}
+
+constexpr size_t from7bitEncodedSize(size_t size)
+{
+    return (size + 1) * 7 / 8;
+}
+
 std::vector<std::byte> to7bitEncoding(std::span<const std::byte> input);
 std::vector<std::byte> from7bitEncoding(std::span<const std::byte> input);
 
+/// Base64 encoding (RFC 4648) with padding, to store binary data in text
+/// documents.
+std::string toBase64(std::span<const std::byte> input);
+/// @return std::errc::illegal_byte_sequence if the input is not valid base64
+Expected<std::vector<std::byte>> fromBase64(std::string_view input);
+
 } // namespace paddock
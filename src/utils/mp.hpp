@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
+
 namespace paddock
 {
 namespace mp
@@ -51,5 +54,27 @@ struct join<Types<Ts...>, Types<Us...>, remainder...>
 template <typename... Lists>
 using join = detail::join<Lists...>::type;
 
+namespace detail
+{
+template <typename T, typename List>
+struct indexOf;
+
+template <typename T, typename... Ts>
+struct indexOf<T, Types<Ts...>>
+{
+    static constexpr size_t value = [] {
+        size_t index = 0;
+        // Stops counting at the first match
+        (void)((std::is_same_v<T, Ts> ? false : (++index, true)) && ...);
+        return index;
+    }();
+    static_assert(value != sizeof...(Ts), "Type not in list");
+};
+} // namespace detail
+
+/// The position of T in List
+template <typename T, class List>
+constexpr size_t indexOf = detail::indexOf<T, List>::value;
+
 } // namespace mp
 } // namespace paddock
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "utils/RcuPointer.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace paddock
+{
+namespace
+{
+struct Object
+{
+    int value;
+    int copy;
+
+    explicit Object(int v)
+        : value{v}
+        , copy{v}
+    {
+    }
+
+    ~Object()
+    {
+        // Poison the object to catch readers using it after reclamation.
+        value = -1;
+        copy = -2;
+    }
+};
+} // namespace
+
+TEST(RcuPointer, empty)
+{
+    RcuPointer<Object> pointer;
+    auto object = pointer.read();
+    ASSERT_FALSE(object);
+}
+
+TEST(RcuPointer, publish)
+{
+    RcuPointer<Object> pointer{std::make_unique<Object>(1)};
+    {
+        auto object = pointer.read();
+        ASSERT_TRUE(object);
+        ASSERT_EQ(object->value, 1);
+    }
+    pointer.publish(std::make_unique<Object>(2));
+    ASSERT_EQ(pointer.read()->value, 2);
+    ASSERT_EQ(pointer.unsafeGet()->value, 2);
+}
+
+TEST(RcuPointer, concurrent_readers)
+{
+    RcuPointer<Object> pointer{std::make_unique<Object>(0)};
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i != 4; ++i)
+    {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done)
+            {
+                auto object = pointer.read();
+                if (object->value != object->copy || object->value < last)
+                    ++errors;
+                last = object->value;
+            }
+        });
+    }
+
+    for (int i = 1; i != 2000; ++i)
+        pointer.publish(std::make_unique<Object>(i));
+
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    ASSERT_EQ(errors, 0);
+    ASSERT_EQ(pointer.read()->value, 1999);
+}
+
+} // namespace paddock
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "utils/SpscQueue.hpp"
+
+#include <thread>
+
+namespace paddock
+{
+TEST(SpscQueue, capacity)
+{
+    SpscQueue<int> queue{5};
+    EXPECT_EQ(queue.capacity(), 8);
+
+    for (int i = 0; i != 8; ++i)
+        EXPECT_TRUE(queue.push(i));
+    EXPECT_FALSE(queue.push(8));
+
+    EXPECT_EQ(queue.pop(), 0);
+    EXPECT_TRUE(queue.push(8));
+    for (int i = 1; i != 9; ++i)
+        EXPECT_EQ(queue.pop(), i);
+    EXPECT_FALSE(queue.pop());
+}
+
+TEST(SpscQueue, threads)
+{
+    constexpr int count = 100000;
+    SpscQueue<int> queue{64};
+
+    std::thread producer{[&queue] {
+        for (int i = 0; i != count; ++i)
+        {
+            while (!queue.push(i))
+                std::this_thread::yield();
+        }
+    }};
+
+    for (int expected = 0; expected != count;)
+    {
+        if (auto value = queue.pop())
+        {
+            ASSERT_EQ(*value, expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+} // namespace paddock
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "utils/TripleBuffer.hpp"
+
+#include <thread>
+
+namespace paddock
+{
+TEST(TripleBuffer, latest_value)
+{
+    TripleBuffer<int> buffer{-1};
+    EXPECT_EQ(buffer.read(), -1);
+
+    buffer.write(1);
+    EXPECT_EQ(buffer.read(), 1);
+    EXPECT_EQ(buffer.read(), 1);
+
+    buffer.write(2);
+    buffer.write(3);
+    buffer.write(4);
+    EXPECT_EQ(buffer.read(), 4);
+}
+
+TEST(TripleBuffer, threads)
+{
+    struct Pair
+    {
+        int a{0};
+        int b{0};
+    };
+    constexpr int count = 100000;
+    TripleBuffer<Pair> buffer;
+
+    std::thread producer{[&buffer] {
+        for (int i = 1; i <= count; ++i)
+            buffer.write(Pair{i, -i});
+    }};
+
+    // Values are never torn and never go back in time.
+    int last = 0;
+    while (last != count)
+    {
+        const auto value = buffer.read();
+        ASSERT_EQ(value.a, -value.b);
+        ASSERT_GE(value.a, last);
+        last = value.a;
+    }
+    producer.join();
+}
+
+} // namespace paddock
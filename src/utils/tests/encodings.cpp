@@ -3,6 +3,8 @@
 #include "utils/byte.hpp"
 #include "utils/encodings.hpp"
 
+#include <random>
+
 namespace paddock
 {
 using Bytes = std::vector<std::byte>;
@@ -135,4 +137,108 @@ TEST(from7bitEncoding, 16_bytes)
                      0x00_b, 0xFF_b, 0x00_b, 0xFF_b, 0x00_b, 0xFF_b, 0x00_b}));
 }
 
+namespace
+{
+// Bit by bit reference of the 7-bit encoding.
+Bytes repack(const Bytes& input, int inBits, int outBits, size_t outSize)
+{
+    Bytes output(outSize);
+    size_t outBit = 0;
+    for (auto byte : input)
+    {
+        for (int bit = inBits - 1; bit >= 0 && outBit / outBits < outSize;
+             --bit, ++outBit)
+        {
+            if ((std::to_integer<int>(byte) >> bit) & 1)
+            {
+                output[outBit / outBits] |=
+                    std::byte(1 << (outBits - 1 - outBit % outBits));
+            }
+        }
+    }
+    return output;
+}
+
+Bytes makeRandomBytes(size_t size, unsigned char mask)
+{
+    std::mt19937 generator{size};
+    std::uniform_int_distribution<int> distribution{0, 255};
+    Bytes bytes(size);
+    for (auto& byte : bytes)
+        byte = std::byte(distribution(generator) & mask);
+    return bytes;
+}
+} // namespace
+
+TEST(to7bitEncoding, matches_reference)
+{
+    // Long enough to go through all the vectorized and scalar paths.
+    for (size_t size = 0; size != 200; ++size)
+    {
+        const auto input = makeRandomBytes(size, 0xFF);
+        ASSERT_EQ(to7bitEncoding(input),
+                  repack(input, 8, 7, to7bitEncodedSize(size)))
+            << "size " << size;
+    }
+}
+
+TEST(from7bitEncoding, matches_reference)
+{
+    for (size_t size = 0; size != 200; ++size)
+    {
+        const auto input = makeRandomBytes(size, 0x7F);
+        ASSERT_EQ(from7bitEncoding(input),
+                  repack(input, 7, 8, from7bitEncodedSize(size)))
+            << "size " << size;
+    }
+}
+
+TEST(encodings, round_trip)
+{
+    for (size_t size = 0; size != 200; ++size)
+    {
+        const auto input = makeRandomBytes(size, 0xFF);
+        auto output = from7bitEncoding(to7bitEncoding(input));
+        // The padding of the last group may add a trailing zero byte.
+        output.resize(size);
+        ASSERT_EQ(output, input) << "size " << size;
+    }
+}
+
+TEST(base64, rfc4648_vectors)
+{
+    const std::pair<std::string, std::string> vectors[] = {
+        {"", ""},
+        {"f", "Zg=="},
+        {"fo", "Zm8="},
+        {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="},
+        {"fooba", "Zm9vYmE="},
+        {"foobar", "Zm9vYmFy"}};
+
+    for (const auto& [text, encoded] : vectors)
+    {
+        const auto bytes = std::as_bytes(std::span{text});
+        ASSERT_EQ(toBase64(bytes), encoded);
+        ASSERT_EQ(fromBase64(encoded), Bytes(bytes.begin(), bytes.end()));
+    }
+}
+
+TEST(base64, round_trip)
+{
+    for (size_t size = 0; size != 200; ++size)
+    {
+        const auto input = makeRandomBytes(size, 0xFF);
+        ASSERT_EQ(fromBase64(toBase64(input)), input);
+    }
+}
+
+TEST(base64, invalid_input)
+{
+    ASSERT_FALSE(fromBase64("Zm9"));
+    ASSERT_FALSE(fromBase64("Zm9=Zm9v"));
+    ASSERT_FALSE(fromBase64("Zm9v\n"));
+    ASSERT_FALSE(fromBase64("Z==="));
+}
+
 } // namespace paddock